@@ -1,19 +1,69 @@
 // Implementations of algorithms described in `algos.h`
 
 #include "algos.h"
+#include "smallmatrix.h"    // SmallMatrix, power overload
+#include "structs.h"        // Matrix
+
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
+#include <iostream>         // std::cout
+#include <stdexcept>        // std::invalid_argument, std::overflow_error
+#include <vector>           // std::vector
 
 // Exponentiation by Squaring
 std::int_fast64_t exp_by_sqr( int base, int exp )
 {
-  std::int_fast64_t result { 1 };
-  while ( exp )
-  {
-    if ( exp & 1 )
-      result *= base;
+  if ( exp < 0 )
+    throw std::invalid_argument { "error: negative exponent for integer exponentiation.\n" };
 
-    exp >>= 1;
-    base *= base;
+  // squaring in the 64 bit result type, instead of `int`, so `base` can not overflow before the result does
+  return checked_power<std::int_fast64_t>( base, static_cast<std::uint64_t>(exp) );
+}
+
+// Simple test function for the exponentiation demo
+void testPower()
+{
+  std::cout << exp_by_sqr( 3, 39 ) << '\n';                             // base ^ 2 overflows `int` long before this
+  try
+  {
+    std::cout << exp_by_sqr( 3, 40 ) << '\n';
+  }
+  catch ( std::overflow_error& exception )
+  {
+    std::cerr << exception.what();
   }
 
-  return result;
-}
+  std::cout << power( ModularInteger<1'000'000'007> { 2 }, 1'000'000'006 ).value() << '\n';  // Fermat : 2^(p-1) = 1 mod p
+  std::cout << power( 1.5, 10 ) << '\n';
+
+  constexpr SmallMatrix<long long, 2, 2> fibonacciStep { { 1, 1 }, { 1, 0 } };
+  static_assert( power( fibonacciStep, 90 )[0][1] == 2'880'067'194'370'816'120LL, "F(90)" );   // at compile time
+
+  const Matrix<double> A { 3, 3, {
+    { 0.5, 0.25, 0 },
+    { 0, 0.5, 0.25 },
+    { 0.25, 0, 0.5 }
+  } };
+  A.pow( 13 ).view();                                                   // 3 buffers, however large the exponent
+  power( A, 13, A.pow( 0 ) ).view();                                    // generic engine, allocates per product
+
+  // batch exponentiation against a scalar loop
+  constexpr size_t count { 1 << 20 };
+  std::vector<double> bases( count ), batch( count ), scalar( count );
+  for ( size_t i { 0 }; i < count; ++i )
+    bases[i] = 1.0 + static_cast<double>(i) / count * 1e-6;
+
+  for ( const std::uint64_t exp : { 15ULL, 1'000ULL, 1'000'000ULL } )
+  {
+    auto start { std::chrono::steady_clock::now() };
+    power_batch( bases.data(), batch.data(), count, exp );
+    const std::chrono::duration<double, std::milli> batchTime { std::chrono::steady_clock::now() - start };
+
+    start = std::chrono::steady_clock::now();
+    for ( size_t i { 0 }; i < count; ++i )
+      scalar[i] = power( bases[i], exp );
+    const std::chrono::duration<double, std::milli> scalarTime { std::chrono::steady_clock::now() - start };
+
+    std::cout << count << " bases ^ " << exp << " : batch " << batchTime.count() << " ms, scalar "
+      << scalarTime.count() << " ms, " << (batch == scalar ? "identical" : "DIFFERENT") << '\n';
+  }
+}
\ No newline at end of file
@@ -1,7 +1,13 @@
 #ifndef __algos_h__
 #define __algos_h__
 
-#include <cstdint>          // for `std::int_fast64_t`
+#include <cstddef>          // std::size_t
+#include <cstdint>          // for `std::int_fast64_t`, std::uint32_t, std::uint64_t
+#include <functional>       // std::multiplies
+#include <limits>           // std::numeric_limits
+#include <stdexcept>        // std::overflow_error
+#include <type_traits>      // std::enable_if_t, std::is_constructible_v, std::is_integral_v, std::is_signed_v
+#include <utility>          // std::move
 
 /* Exponentiation by Squaring - time complexity = O(log(exp))
  * Naive approach is O(exp) complexity because we multiply `base` into a result `exp` times.
@@ -9,7 +15,163 @@
  * `exp` = w(2^0) + z(2^1) + y(2^2) + x(2^3) implies that base ^ exp can be expanded as --
  * base ^ w * (base ^ 2) ^ z * (base ^ 4) ^ y * (base ^ 8) ^ x, where xyzw are 0/1.
  * Every iteration, `base` is squared and the corresponding bit of `exp` is used.
+ * Throws `std::overflow_error` if the result does not fit, and `std::invalid_argument` for a negative `exp`.
  */
 std::int_fast64_t exp_by_sqr( int base, int exp );
 
+/* Generic Exponentiation by Squaring, for any type with an associative multiplication (a monoid).
+ * `identity` is the neutral element of `multiply`, it is the result for `exp` == 0.
+ * The squaring after the highest bit of `exp` is skipped, since its value would never be used; otherwise `base`
+ * can overflow (or, for matrices, do a whole extra product) even when the result does not.
+ * Time complexity ~ O(log(exp)) multiplications.
+ */
+template<typename _Monoid, typename _Multiply = std::multiplies<>>
+constexpr _Monoid power( _Monoid base, std::uint64_t exp, _Monoid identity, _Multiply multiply = _Multiply { } )
+{
+  _Monoid result { std::move( identity ) };
+  while ( exp )
+  {
+    if ( exp & 1 )
+      result = multiply( result, base );
+
+    exp >>= 1;
+    if ( exp )
+      base = multiply( base, base );
+  }
+
+  return result;
+}
+
+// Overload for types where `_Monoid { 1 }` is the multiplicative identity (built-in numbers, `ModularInteger`).
+template<typename _Monoid, typename = std::enable_if_t<std::is_constructible_v<_Monoid, int>>>
+constexpr _Monoid power( const _Monoid& base, const std::uint64_t exp )
+{
+  return power( base, exp, _Monoid { 1 } );
+}
+
+/* Multiplies 2 integers, throwing `std::overflow_error` instead of overflowing silently (or, for signed
+ * integers, with undefined behavior). The checks only divide, so they can not overflow themselves.
+ */
+template<typename _Integer>
+constexpr _Integer checked_multiply( const _Integer a, const _Integer b )
+{
+  static_assert( std::is_integral_v<_Integer>, "checked_multiply requires an integral type" );
+  constexpr _Integer max { std::numeric_limits<_Integer>::max() };
+  constexpr _Integer min { std::numeric_limits<_Integer>::min() };
+
+  bool overflow { false };
+  if constexpr ( std::is_signed_v<_Integer> )
+  {
+    if ( a > 0 )
+      overflow = (b > 0) ? (a > max / b) : (b < min / a);
+    else if ( a < 0 )
+      overflow = (b > 0) ? (a < min / b) : (b != 0 && b < max / a);
+  }
+  else
+    overflow = (b != 0 && a > max / b);
+
+  if ( overflow )
+    throw std::overflow_error { "error: integer multiplication overflowed.\n" };
+
+  return a * b;
+}
+
+/* Exponentiation by Squaring for integers, with overflow detection.
+ * Since the final squaring is skipped, `base` is only squared when the square is needed for the result,
+ * so every reported overflow is a genuine overflow of the result.
+ */
+template<typename _Integer>
+constexpr _Integer checked_power( const _Integer base, const std::uint64_t exp )
+{
+  return power( base, exp, _Integer { 1 }, [] ( const _Integer a, const _Integer b ) { return checked_multiply( a, b ); } );
+}
+
+/* Raises every element of `bases` to the same power `exp`, writing into `results` (which may alias `bases`).
+ * Since the exponent is shared, every element takes the same multiply / square decisions. So instead of one
+ * loop over bits per element, the bits drive the outer loop and the inner loops are plain element-wise products
+ * over a block, with no branches or dependencies between elements, which compilers auto-vectorize.
+ * Blocks of 256 elements keep the working set in L1 cache.
+ * Time complexity ~ O(count * log(exp)).
+ */
+template<typename _Monoid>
+void power_batch( const _Monoid* const bases, _Monoid* const results, const std::size_t count, const std::uint64_t exp )
+{
+  constexpr std::size_t blockSize { 256 };
+  _Monoid squares[blockSize];
+  _Monoid block[blockSize];
+
+  for ( std::size_t first { 0 }; first < count; first += blockSize )
+  {
+    const std::size_t size { (count - first < blockSize) ? count - first : blockSize };
+    for ( std::size_t i { 0 }; i < size; ++i )
+    {
+      squares[i] = bases[first + i];
+      block[i] = _Monoid { 1 };
+    }
+
+    for ( std::uint64_t bits { exp }; bits; )
+    {
+      if ( bits & 1 )
+        for ( std::size_t i { 0 }; i < size; ++i )
+          block[i] = block[i] * squares[i];
+
+      bits >>= 1;
+      if ( bits )
+        for ( std::size_t i { 0 }; i < size; ++i )
+          squares[i] = squares[i] * squares[i];
+    }
+
+    for ( std::size_t i { 0 }; i < size; ++i )
+      results[first + i] = block[i];
+  }
+}
+
+/*////////////////////////////////////// Integers modulo a compile-time constant //////////////////////////////////////
+ *
+ * The value is always kept reduced into [0, _Modulus). Products are formed in 64 bits before reducing,
+ * so they can not overflow for any 32 bit modulus. With `power`, this gives modular exponentiation.
+ */
+template<std::uint32_t _Modulus>
+class ModularInteger
+{
+  static_assert( _Modulus > 0, "modulus must be positive" );
+
+  std::uint32_t __value;
+
+public:
+
+  constexpr ModularInteger() : __value { 0 } { }
+  constexpr ModularInteger( const std::int64_t value ) :
+    __value { static_cast<std::uint32_t>(((value % static_cast<std::int64_t>(_Modulus)) + _Modulus) % _Modulus) }
+  { }
+
+  constexpr std::uint32_t value() const { return __value; }
+  static constexpr std::uint32_t modulus() { return _Modulus; }
+
+  constexpr ModularInteger operator+( const ModularInteger other ) const
+  {
+    return fromReduced( static_cast<std::uint32_t>((std::uint64_t { __value } + other.__value) % _Modulus) );
+  }
+  constexpr ModularInteger operator-( const ModularInteger other ) const
+  {
+    return fromReduced( static_cast<std::uint32_t>((std::uint64_t { __value } + _Modulus - other.__value) % _Modulus) );
+  }
+  constexpr ModularInteger operator*( const ModularInteger other ) const
+  {
+    return fromReduced( static_cast<std::uint32_t>(std::uint64_t { __value } * other.__value % _Modulus) );
+  }
+  constexpr bool operator==( const ModularInteger other ) const { return __value == other.__value; }
+  constexpr bool operator!=( const ModularInteger other ) const { return __value != other.__value; }
+
+  // skips the reduction for a value already known to be in [0, _Modulus)
+  static constexpr ModularInteger fromReduced( const std::uint32_t value )
+  {
+    ModularInteger result;
+    result.__value = value;
+    return result;
+  }
+};
+
+void testPower();                                         // demo function
+
 #endif
\ No newline at end of file
@@ -0,0 +1,239 @@
+// Benchmark executable : sweeps of every sort, `Matrix` operation and fibonacci function, with JSON baselines
+
+#include "harness.h"
+#include "fibonacci.h"      // fibonacci_*, FibonacciMethod, ModularQuery
+#include "pool.h"           // PoolScope
+#include "sort.h"           // sort, SortType
+#include "structs.h"        // Matrix
+
+#include <cstdint>          // std::uint64_t
+#include <cstdlib>          // EXIT_SUCCESS, EXIT_FAILURE, std::strtod
+#include <exception>        // std::exception
+#include <execution>        // std::execution::par
+#include <iostream>         // std::cout, std::cerr
+#include <iterator>         // std::size
+#include <random>           // std::mt19937_64
+#include <stdexcept>        // std::logic_error
+#include <string>           // std::string, std::to_string
+#include <utility>          // std::pair
+#include <vector>           // std::vector
+
+/* Every algorithm of `sort` on every input distribution. The quadratic ones get smaller inputs.
+ * The heap sort is not implemented yet (it leaves the input as it is), so it is not measured.
+ * Elements : values sorted.
+ */
+static void benchmarkSort( BenchmarkRunner& runner, const bool quick )
+{
+  const std::pair<SortType, const char*> types[] {
+    { SortType::Bubble, "bubble" }, { SortType::Selection, "selection" }, { SortType::Insertion, "insertion" },
+    { SortType::Merge, "merge" }, { SortType::Quick, "quick" }, { SortType::Shell, "shell" }, { SortType::STD, "std" }
+  };
+  const std::vector<size_t> quadraticSizes { quick ? std::vector<size_t> { 256, 1024 }
+                                                   : std::vector<size_t> { 256, 1024, 4096 } };
+  const std::vector<size_t> sizes { quick ? std::vector<size_t> { 1 << 10, 1 << 14 }
+                                          : std::vector<size_t> { 1 << 10, 1 << 13, 1 << 16 } };
+
+  for ( const auto& [type, name] : types )
+    for ( const size_t size : (type <= SortType::Insertion) ? quadraticSizes : sizes )
+      for ( const Distribution distribution : distributions )
+      {
+        const std::string benchmark { std::string { "sort/" } + name + '/' + distribution_name( distribution ) + '/'
+                                      + std::to_string( size ) };
+        if ( !runner.selected( benchmark ) ) continue;
+
+        const std::vector<int> input { make_input( distribution, size ) };
+        std::vector<int> data;
+        sort sorter { type };
+        runner.run( benchmark, size, [&] { data = input; }, [&] { sorter( data.begin(), data.end() ); } );
+        if ( !sort::check( data.begin(), data.end() ) )
+          throw std::logic_error { "error: " + benchmark + " did not sort its input.\n" };
+      }
+}
+
+/* Every arithmetic operation of `Matrix<double>` and its transposes, on random square matrices.
+ * Elements : elements of the result, but multiply-adds for the products.
+ */
+static void benchmarkMatrix( BenchmarkRunner& runner, const bool quick )
+{
+  const std::vector<size_t> sizes { quick ? std::vector<size_t> { 64, 256 }
+                                          : std::vector<size_t> { 64, 256, 512, 1024 } };
+  for ( const size_t n : sizes )
+  {
+    const std::string suffix { '/' + std::to_string( n ) };
+    Matrix<double> a { n, n }, b { n, n }, result { n, n }, small { n, n };
+    const std::vector<int> values { make_input( Distribution::Random, 2 * n * n ) };
+    for ( size_t i { 0 }; i < n * n; ++i )
+    {
+      a.begin()[i] = values[i] / double { 1 << 30 };
+      b.begin()[i] = values[n * n + i] / double { 1 << 30 };
+      small.begin()[i] = a.begin()[i] / n;                // keeps the powers finite
+    }
+
+    runner.run( "matrix/add" + suffix, n * n, [&] { result = a + b; } );
+    runner.run( "matrix/subtract" + suffix, n * n, [&] { result = a - b; } );
+    runner.run( "matrix/negate" + suffix, n * n, [&] { result = -a; } );
+    runner.run( "matrix/scale" + suffix, n * n, [&] { result = a * 0.5; } );
+    runner.run( "matrix/add-assign" + suffix, n * n, [&] { result += b; } );
+    {
+      PoolScope scope;                                    // every sum reuses the block freed by the previous one
+      runner.run( "matrix/add-pooled" + suffix, n * n, [&] { result = a + b; } );
+    }
+    runner.run( "matrix/transpose" + suffix, n * n, [&] { a.transpose( result ); } );
+    runner.run( "matrix/transpose-returning" + suffix, n * n, [&] { result = a.transpose(); } );
+    runner.run( "matrix/transpose-in-place" + suffix, n * n, [&] { result.transposeInPlace(); } );
+    if ( n > 512 ) continue;                              // a product of 1024 x 1024 takes about half a second
+    runner.run( "matrix/multiply" + suffix, n * n * n, [&] { result = a * b; } );
+    runner.run( "matrix/multiply-par" + suffix, n * n * n, [&] { result = a.multiply( std::execution::par, b ); } );
+    runner.run( "matrix/pow8" + suffix, 4 * n * n * n, [&] { result = small.pow( 8 ); } );   // 3 squares, 1 product
+  }
+}
+
+/* Every fibonacci function. The `int` functions compute the whole series they can, F(0) to F(46), from empty
+ * caches ("cold") and from full ones ("warm"). The others sweep their size.
+ * Elements : fibonacci numbers computed, but calls for `fibonacci_big`.
+ */
+static void benchmarkFibonacci( BenchmarkRunner& runner, const bool quick )
+{
+  if ( runner.selected( "fibonacci/auto" ) )
+    fibonacci_calibrate();                                // measures the crossovers once, before any timing
+
+  constexpr size_t intCounts { 47 };
+  const std::pair<FibonacciMethod, const char*> methods[] {
+    { FibonacciMethod::RDP, "rdp" }, { FibonacciMethod::IDP, "idp" }, { FibonacciMethod::MAT, "mat" },
+    { FibonacciMethod::FD, "fd" }
+  };
+  for ( const auto& [method, name] : methods )
+  {
+    const auto series { [method = method]
+    {
+      std::uint64_t sum { 0 };                            // F(0) + ... + F(46) = F(48) - 1 overflows `int`
+      for ( size_t count { 0 }; count < intCounts; ++count )
+        sum += fibonacci_call( method, count );
+      keep( sum );
+    } };
+    runner.run( std::string { "fibonacci/" } + name + "/cold/47", intCounts, fibonacci_clear_caches, series );
+    runner.run( std::string { "fibonacci/" } + name + "/warm/47", intCounts, series );
+  }
+  const auto autoSeries { []
+  {
+    std::uint64_t sum { 0 };
+    for ( size_t count { 0 }; count < intCounts; ++count )
+      sum += fibonacci_auto( count );
+    keep( sum );
+  } };
+  runner.run( "fibonacci/auto/cold/47", intCounts, fibonacci_clear_caches, autoSeries );
+  runner.run( "fibonacci/auto/warm/47", intCounts, autoSeries );
+
+  constexpr size_t tableCounts { FibonacciTable<std::uint64_t>::size };
+  runner.run( "fibonacci/table64/" + std::to_string( tableCounts ), tableCounts, []
+  {
+    std::uint64_t sum { 0 };
+    for ( size_t count { 0 }; count < tableCounts; ++count )
+      sum += fibonacci_table<std::uint64_t>( count );
+    keep( sum );
+  } );
+
+  const std::vector<size_t> bigCounts { quick ? std::vector<size_t> { 1000, 100000 }
+                                              : std::vector<size_t> { 1000, 10000, 100000, 1000000 } };
+  for ( const size_t count : bigCounts )
+    runner.run( "fibonacci/big/" + std::to_string( count ), 1, [count] { keep( fibonacci_big( count ).limbs() ); } );
+
+  // random indices up to 2^62 against a few moduli below 2^32, as `testFibonacciMod`
+  const std::vector<size_t> batchSizes { quick ? std::vector<size_t> { 1 << 10, 1 << 14 }
+                                               : std::vector<size_t> { 1 << 10, 1 << 14, 1 << 18 } };
+  std::mt19937_64 generator { 2021 };
+  const std::uint64_t moduli[] { 1'000'000'007ULL, 998'244'353ULL, 4'294'967'291ULL, 1ULL << 31, 10'000ULL, 3ULL };
+  for ( const size_t size : batchSizes )
+  {
+    std::vector<ModularQuery> queries( size );
+    for ( auto& query : queries )
+      query = { generator() >> 2, moduli[generator() % std::size( moduli )] };
+    std::vector<std::uint64_t> results( size );
+    runner.run( "fibonacci/mod/" + std::to_string( size ), size, [&]
+    {
+      for ( size_t i { 0 }; i < size; ++i )
+        results[i] = fibonacci_mod( queries[i].n, queries[i].m );
+    } );
+    runner.run( "fibonacci/mod-batch/" + std::to_string( size ), size,
+                [&] { fibonacci_mod_batch( queries.data(), results.data(), size ); } );
+  }
+
+  const std::vector<size_t> rangeSizes { quick ? std::vector<size_t> { 1 << 12, 1 << 16 }
+                                               : std::vector<size_t> { 1 << 12, 1 << 16, 1 << 20 } };
+  for ( const size_t size : rangeSizes )
+  {
+    std::vector<std::uint64_t> values( size );
+    runner.run( "fibonacci/range-wrapping/" + std::to_string( size ), size,
+                [&] { fibonacci_range( 1000, 1000 + size, values.data() ); } );
+    runner.run( "fibonacci/range-mod/" + std::to_string( size ), size,
+                [&] { fibonacci_range( 1000, 1000 + size, values.data(), 1'000'000'007ULL ); } );
+  }
+}
+
+static void printUsage()
+{
+  std::cout << "usage: benchmark [--quick] [--filter <text>] [--save <file>] [--compare <file>] [--threshold <ratio>]\n"
+    "  --quick              smaller sizes, for a run of a few seconds\n"
+    "  --filter <text>      only the benchmarks whose name contains <text>, e.g. sort/quick or /zipf/\n"
+    "  --save <file>        writes the results as a JSON baseline\n"
+    "  --compare <file>     fails if a median is slower than in the baseline by more than the threshold\n"
+    "                       and by more than 3 deviations\n"
+    "  --threshold <ratio>  allowed slowdown for --compare, 0.10 (10%) by default\n";
+}
+
+int main( int argc, char* argv[] )
+{
+  bool quick { false };
+  std::string filter, saveFile, compareFile;
+  double threshold { 0.10 };
+  for ( int i { 1 }; i < argc; ++i )
+  {
+    const std::string option { argv[i] };
+    const bool hasValue { i + 1 < argc };
+    if ( option == "--quick" ) quick = true;
+    else if ( option == "--filter" && hasValue ) filter = argv[++i];
+    else if ( option == "--save" && hasValue ) saveFile = argv[++i];
+    else if ( option == "--compare" && hasValue ) compareFile = argv[++i];
+    else if ( option == "--threshold" && hasValue ) threshold = std::strtod( argv[++i], nullptr );
+    else
+    {
+      printUsage();
+      return (option == "--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  try
+  {
+    // read first, so that a bad baseline fails before the long run
+    const std::vector<BenchmarkResult> baseline { compareFile.empty() ? std::vector<BenchmarkResult> { }
+                                                                      : load_baseline( compareFile ) };
+
+    BenchmarkRunner runner { filter };
+    if ( quick )
+      runner.minimumTime = 0.05;
+    print_header();
+    benchmarkSort( runner, quick );
+    benchmarkMatrix( runner, quick );
+    benchmarkFibonacci( runner, quick );
+
+    if ( !saveFile.empty() )
+    {
+      save_baseline( runner.results(), saveFile );
+      std::cout << "saved " << runner.results().size() << " results to " << saveFile << '\n';
+    }
+    if ( compareFile.empty() )
+      return EXIT_SUCCESS;
+
+    const std::vector<Regression> regressions { find_regressions( baseline, runner.results(), threshold ) };
+    for ( const Regression& regression : regressions )
+      std::cout << "REGRESSION " << regression.name << " : " << regression.baseline << " -> " << regression.current
+        << " ns/element (+" << 100 * (regression.current / regression.baseline - 1) << "%)\n";
+    std::cout << regressions.size() << " regressions beyond " << 100 * threshold << "% and the noise against " << compareFile << '\n';
+    return regressions.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  catch ( const std::exception& error )
+  {
+    std::cerr << error.what();
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,282 @@
+// Implementation of the benchmark harness described in `harness.h`
+
+#include "harness.h"
+#include "trace.h"          // write_json_string
+
+#include <algorithm>        // std::sort, std::upper_bound, std::reverse
+#include <cctype>           // std::isspace
+#include <cmath>            // std::sqrt
+#include <cstdlib>          // std::strtod
+#include <fstream>          // std::ifstream, std::ofstream
+#include <iomanip>          // std::setw, std::setprecision
+#include <iterator>         // std::istreambuf_iterator
+#include <map>              // std::map
+#include <numeric>          // std::accumulate
+#include <random>           // std::mt19937_64
+#include <stdexcept>        // std::invalid_argument, std::runtime_error
+
+const char* distribution_name( const Distribution distribution )
+{
+  switch ( distribution )
+  {
+  case Distribution::Random: return "random";
+  case Distribution::Sorted: return "sorted";
+  case Distribution::Reversed: return "reversed";
+  case Distribution::FewUnique: return "few-unique";
+  case Distribution::OrganPipe: return "organ-pipe";
+  case Distribution::Zipf: return "zipf";
+  }
+  throw std::invalid_argument { "error: unknown input distribution.\n" };
+}
+
+/* The standard distributions (`std::uniform_int_distribution`...) are free to differ between library implementations,
+ * only the engines are fully specified. So the values are made from the raw bits of `std::mt19937_64` instead.
+ */
+std::vector<int> make_input( const Distribution distribution, const size_t size, const std::uint64_t seed )
+{
+  std::mt19937_64 generator { seed };
+  const auto uniform { [&generator] { return (generator() >> 11) * 0x1.0p-53; } };   // in [0, 1)
+  std::vector<int> values( size );
+
+  switch ( distribution )
+  {
+  case Distribution::Random:
+    for ( auto& value : values )
+      value = static_cast<int>(generator() % ((1ULL << 30) + 1));
+    break;
+
+  case Distribution::Sorted:
+  case Distribution::Reversed:
+    // random values in order, rather than 0, 1, 2... which some algorithms could recognize
+    for ( auto& value : values )
+      value = static_cast<int>(generator() % ((1ULL << 30) + 1));
+    std::sort( values.begin(), values.end() );
+    if ( distribution == Distribution::Reversed )
+      std::reverse( values.begin(), values.end() );
+    break;
+
+  case Distribution::FewUnique:
+    for ( auto& value : values )
+      value = static_cast<int>(generator() % 16) << 26;
+    break;
+
+  case Distribution::OrganPipe:
+    for ( size_t i { 0 }; i < size; ++i )
+      values[i] = static_cast<int>((i < size / 2) ? i : size - 1 - i);
+    break;
+
+  case Distribution::Zipf:
+  {
+    // inverse of the cumulative distribution : P(rank k) is proportional to 1 / k
+    std::vector<double> cumulative( size );
+    double total { 0.0 };
+    for ( size_t rank { 0 }; rank < size; ++rank )
+      cumulative[rank] = total += 1.0 / (rank + 1);
+    for ( auto& value : values )
+      value = static_cast<int>(std::upper_bound( cumulative.begin(), cumulative.end() - 1, uniform() * total )
+                               - cumulative.begin());
+    break;
+  }
+  }
+  return values;
+}
+
+BenchmarkRunner::BenchmarkRunner( const std::string& filter, std::ostream& out ) :
+  __filter { filter },
+  __out { out }
+{ }
+
+bool BenchmarkRunner::selected( const std::string& name ) const
+{
+  return name.find( __filter ) != std::string::npos;
+}
+
+// Turns the sample times (seconds) into nanoseconds per element, and prints the result.
+void BenchmarkRunner::__record( const std::string& name, const size_t elements, std::vector<double>& times )
+{
+  const double scale { 1e9 / static_cast<double>(elements ? elements : 1) };
+  for ( auto& time : times )
+    time *= scale;
+  std::sort( times.begin(), times.end() );
+
+  const size_t samples { times.size() };
+  const double median { (samples % 2) ? times[samples / 2] : (times[samples / 2 - 1] + times[samples / 2]) / 2 };
+  const double mean { std::accumulate( times.begin(), times.end(), 0.0 ) / samples };
+  double squares { 0.0 };
+  for ( const double time : times )
+    squares += (time - mean) * (time - mean);
+  const double deviation { (samples > 1) ? std::sqrt( squares / (samples - 1) ) : 0.0 };
+
+  __results.push_back( { name, elements, samples, median, mean, deviation, 1e9 / median } );
+  __out << std::left << std::setw( 44 ) << name << std::right << std::setw( 10 ) << elements << std::setw( 8 )
+    << samples << std::fixed << std::setprecision( 3 ) << std::setw( 14 ) << median << std::setw( 14 ) << mean
+    << std::setprecision( 1 ) << std::setw( 9 ) << 100 * deviation / mean << '%' << std::setprecision( 2 )
+    << std::setw( 14 ) << 1e3 / median << std::defaultfloat << std::endl;
+}
+
+void print_header( std::ostream& out )
+{
+  out << std::left << std::setw( 44 ) << "benchmark" << std::right << std::setw( 10 ) << "elements" << std::setw( 8 )
+    << "samples" << std::setw( 14 ) << "median ns/el" << std::setw( 14 ) << "mean ns/el" << std::setw( 10 )
+    << "deviation" << std::setw( 14 ) << "M elements/s" << '\n';
+}
+
+void save_baseline( const std::vector<BenchmarkResult>& results, const std::string& fileName )
+{
+  std::ofstream file { fileName };
+  if ( !file )
+    throw std::runtime_error { "error: could not open the baseline file for writing.\n" };
+
+  file << "{\n\"version\": 1,\n\"unit\": \"ns/element\",\n\"results\": [" << std::setprecision( 17 );
+  for ( size_t i { 0 }; i < results.size(); ++i )
+  {
+    const BenchmarkResult& result { results[i] };
+    file << (i ? ",\n" : "\n") << "  {\"name\": ";
+    write_json_string( file, result.name );
+    file << ", \"elements\": " << result.elements << ", \"samples\": " << result.samples << ", \"median\": "
+      << result.median << ", \"mean\": " << result.mean << ", \"deviation\": " << result.deviation
+      << ", \"throughput\": " << result.throughput << '}';
+  }
+  file << "\n]\n}\n";
+  if ( !file )
+    throw std::runtime_error { "error: could not write the baseline file.\n" };
+}
+
+/* Reads the JSON written by `save_baseline`, i.e. an object whose "results" member is an array of flat objects
+ * with string and number members. Other members are skipped, so later versions may add some.
+ */
+class BaselineReader
+{
+  const std::string& __text;
+  size_t __position { 0 };
+
+  [[noreturn]] void __fail() const { throw std::runtime_error { "error: the baseline file is not valid.\n" }; }
+
+public:
+
+  explicit BaselineReader( const std::string& text ) : __text { text } { }
+
+  // skips white space, then returns the next character without consuming it (0 at the end)
+  char peek()
+  {
+    while ( __position < __text.size() && std::isspace( static_cast<unsigned char>(__text[__position]) ) )
+      ++__position;
+    return (__position < __text.size()) ? __text[__position] : '\0';
+  }
+
+  void expect( const char c )
+  {
+    if ( peek() != c ) __fail();
+    ++__position;
+  }
+
+  bool consume( const char c )
+  {
+    if ( peek() != c ) return false;
+    ++__position;
+    return true;
+  }
+
+  std::string string()
+  {
+    expect( '"' );
+    std::string text;
+    for ( ; __position < __text.size() && __text[__position] != '"'; ++__position )
+    {
+      if ( __text[__position] == '\\' && ++__position == __text.size() ) break;
+      text += __text[__position];
+    }
+    expect( '"' );
+    return text;
+  }
+
+  double number()
+  {
+    peek();
+    const char* const start { __text.c_str() + __position };
+    char* end;
+    const double value { std::strtod( start, &end ) };
+    if ( end == start ) __fail();
+    __position += end - start;
+    return value;
+  }
+
+  // skips a string or a number, the only values of the members that are not read
+  void skip()
+  {
+    if ( peek() == '"' ) string();
+    else number();
+  }
+};
+
+std::vector<BenchmarkResult> load_baseline( const std::string& fileName )
+{
+  std::ifstream file { fileName };
+  if ( !file )
+    throw std::runtime_error { "error: could not open the baseline file.\n" };
+  const std::string text { std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> { } };
+
+  BaselineReader reader { text };
+  std::vector<BenchmarkResult> results;
+  reader.expect( '{' );
+  do
+  {
+    const std::string key { reader.string() };
+    reader.expect( ':' );
+    if ( key != "results" )
+    {
+      reader.skip();
+      continue;
+    }
+
+    reader.expect( '[' );
+    if ( reader.consume( ']' ) ) continue;
+    do
+    {
+      BenchmarkResult result { };
+      reader.expect( '{' );
+      do
+      {
+        const std::string member { reader.string() };
+        reader.expect( ':' );
+        if ( member == "name" ) result.name = reader.string();
+        else if ( member == "elements" ) result.elements = static_cast<size_t>(reader.number());
+        else if ( member == "samples" ) result.samples = static_cast<size_t>(reader.number());
+        else if ( member == "median" ) result.median = reader.number();
+        else if ( member == "mean" ) result.mean = reader.number();
+        else if ( member == "deviation" ) result.deviation = reader.number();
+        else if ( member == "throughput" ) result.throughput = reader.number();
+        else reader.skip();
+      } while ( reader.consume( ',' ) );
+      reader.expect( '}' );
+      results.push_back( result );
+    } while ( reader.consume( ',' ) );
+    reader.expect( ']' );
+  } while ( reader.consume( ',' ) );
+  reader.expect( '}' );
+
+  return results;
+}
+
+std::vector<Regression> find_regressions( const std::vector<BenchmarkResult>& baseline,
+                                          const std::vector<BenchmarkResult>& current, const double threshold,
+                                          const double deviations )
+{
+  std::map<std::string, const BenchmarkResult*> references;
+  for ( const BenchmarkResult& result : baseline )
+    references[result.name] = &result;
+
+  std::vector<Regression> regressions;
+  for ( const BenchmarkResult& result : current )
+  {
+    const auto found { references.find( result.name ) };
+    if ( found == references.end() ) continue;
+
+    const BenchmarkResult& reference { *found->second };
+    const double slowdown { result.median - reference.median };
+    const double noise { std::sqrt( reference.deviation * reference.deviation + result.deviation * result.deviation ) };
+    if ( slowdown > reference.median * threshold && slowdown > deviations * noise )
+      regressions.push_back( { result.name, reference.median, result.median } );
+  }
+  return regressions;
+}
@@ -0,0 +1,154 @@
+#ifndef __harness_h__
+#define __harness_h__
+
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uint64_t
+#include <iostream>         // std::ostream, std::cout
+#include <string>           // std::string
+#include <type_traits>      // std::is_arithmetic_v
+#include <vector>           // std::vector
+
+using size_t = std::size_t;
+
+/*//////////////////////////////////////// Benchmark harness ////////////////////////////////////////
+ *
+ * Every benchmark has a name made of '/' separated parts, "sort/quick/random/65536", and a number of elements,
+ * the unit of its work (values sorted, matrix elements written, multiply-adds, fibonacci numbers...).
+ * A sample runs the untimed setup of the benchmark (copying the unsorted input, clearing caches), then times one
+ * run of its body. Samples are repeated until both `minimumSamples` and `minimumTime` are reached, or
+ * `maximumSamples` is, and the median, mean and standard deviation of the time per element are kept.
+ * Inputs come from `make_input` with a fixed seed, so every run of the benchmark sees exactly the same data.
+ * Results are saved as JSON baselines, and a later run compares its medians against a baseline : a benchmark
+ * slower by more than the threshold, and by more than its noise (a few times the deviations of both runs), is a
+ * regression, and the benchmark executable fails.
+ */
+
+// shapes of the generated input values
+enum class Distribution
+{
+  Random,                                                 // uniform over [0, 2^30]
+  Sorted,                                                 // already in ascending order
+  Reversed,                                               // in descending order
+  FewUnique,                                              // uniform over 16 distinct values
+  OrganPipe,                                              // ascending up to the middle, then descending
+  Zipf                                                    // ranks of a Zipf law of exponent 1 over `size` ranks
+};
+
+constexpr Distribution distributions[] { Distribution::Random, Distribution::Sorted, Distribution::Reversed,
+                                         Distribution::FewUnique, Distribution::OrganPipe, Distribution::Zipf };
+
+const char* distribution_name( Distribution distribution );       // "random", "sorted", "reversed", ...
+
+// `size` values of `distribution`, the same ones for the same arguments on every run and platform
+std::vector<int> make_input( Distribution distribution, size_t size, std::uint64_t seed = 2021 );
+
+// statistics of one benchmark, times in nanoseconds per element
+struct BenchmarkResult
+{
+  std::string name;
+  size_t elements;
+  size_t samples;
+  double median;
+  double mean;
+  double deviation;                                       // standard deviation of the samples
+  double throughput;                                      // elements per second, at the median
+};
+
+// a benchmark whose median grew by more than the threshold and the noise since the baseline
+struct Regression
+{
+  std::string name;
+  double baseline;                                        // median of the baseline, ns per element
+  double current;                                         // median of this run, ns per element
+};
+
+class BenchmarkRunner
+{
+  std::string __filter;                                   // only the benchmarks whose name contains it run
+  std::vector<BenchmarkResult> __results;
+  std::ostream& __out;                                    // every result is printed as soon as it is measured
+
+  void __record( const std::string& name, size_t elements, std::vector<double>& times );
+
+public:
+
+  size_t minimumSamples { 5 };
+  size_t maximumSamples { 50 };
+  double minimumTime { 0.2 };                             // seconds of timed runs per benchmark
+
+  explicit BenchmarkRunner( const std::string& filter = "", std::ostream& out = std::cout );
+
+  bool selected( const std::string& name ) const;         // whether `name` passes the filter
+
+  /* Measures `body()` over `elements` elements, calling `setup()` untimed before every sample.
+   * Skipped if the name does not pass the filter.
+   */
+  template<typename _Setup, typename _Body>
+  void run( const std::string& name, size_t elements, _Setup setup, _Body body );
+
+  // the same, without a setup
+  template<typename _Body>
+  void run( const std::string& name, size_t elements, _Body body ) { run( name, elements, [] { }, body ); }
+
+  const std::vector<BenchmarkResult>& results() const { return __results; }
+};
+
+template<typename _Setup, typename _Body>
+void BenchmarkRunner::run( const std::string& name, const size_t elements, _Setup setup, _Body body )
+{
+  if ( !selected( name ) ) return;
+
+  std::vector<double> times;
+  double total { 0.0 };
+  while ( times.size() < maximumSamples && (times.size() < minimumSamples || total < minimumTime) )
+  {
+    setup();
+    const auto start { std::chrono::steady_clock::now() };
+    body();
+    const std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+    times.push_back( elapsed.count() );
+    total += elapsed.count();
+  }
+  __record( name, elements, times );
+}
+
+/* Keeps a value alive, so that the optimizer can not drop the computation of a body whose result is unused :
+ * numbers are stored into a volatile, other objects have their address stored, as if something read them later.
+ */
+template<typename _Type>
+void keep( const _Type& value )
+{
+  if constexpr ( std::is_arithmetic_v<_Type> )
+  {
+    static volatile _Type sink;
+    sink = value;
+  }
+  else
+  {
+    static const volatile void* volatile sink;
+    sink = &value;
+  }
+}
+
+void print_header( std::ostream& out = std::cout );       // column titles of the printed results
+
+/* Writes `results` into `fileName` as a JSON baseline. Throws `std::runtime_error` if the file can not be written.
+ */
+void save_baseline( const std::vector<BenchmarkResult>& results, const std::string& fileName );
+
+/* Reads a baseline written by `save_baseline`.
+ * Throws `std::runtime_error` if the file can not be read, or is not such a baseline.
+ */
+std::vector<BenchmarkResult> load_baseline( const std::string& fileName );
+
+/* The benchmarks of `current` whose median exceeds the median of the same name in `baseline` both by more than
+ * `threshold` (0.1 = 10% slower) and by more than `deviations` times the deviation of the difference, the square
+ * root of the sum of the squared deviations of both, so that noisy benchmarks need a larger slowdown to count.
+ * Benchmarks missing from either side are not compared.
+ */
+std::vector<Regression> find_regressions( const std::vector<BenchmarkResult>& baseline,
+                                          const std::vector<BenchmarkResult>& current, double threshold,
+                                          double deviations = 3.0 );
+
+#endif
\ No newline at end of file
@@ -0,0 +1,365 @@
+// Implementations of data structures described in `bigint.h`
+
+#include "bigint.h"
+
+#include <algorithm>        // std::copy, std::fill, std::max, std::min, std::reverse, std::swap
+#include <stdexcept>        // std::overflow_error, std::underflow_error
+
+using Limb = std::uint32_t;
+using WideLimb = std::uint64_t;
+
+////////// Kernels on raw limb arrays //////////
+
+// Operands shorter than this many limbs are multiplied by the schoolbook method, where Karatsuba's extra additions
+// and allocations cost more than the multiplications they save.
+static constexpr size_t karatsubaThreshold { 32 };
+
+/* out = a + b, for `na` >= `nb`, writing `na` limbs into `out` (which may alias `a`). Returns the carry out.
+ * Time complexity ~ O(na).
+ */
+static Limb addLimbs( Limb* const out, const Limb* const a, const size_t na, const Limb* const b, const size_t nb )
+{
+  WideLimb carry { 0 };
+  size_t i { 0ULL };
+  for ( ; i < nb; ++i )
+  {
+    carry += WideLimb { a[i] } + b[i];
+    out[i] = static_cast<Limb>(carry);
+    carry >>= 32;
+  }
+  for ( ; i < na; ++i )
+  {
+    carry += a[i];
+    out[i] = static_cast<Limb>(carry);
+    carry >>= 32;
+  }
+  return static_cast<Limb>(carry);
+}
+
+/* out = a - b, for `na` >= `nb`, writing `na` limbs into `out` (which may alias `a`). Returns the borrow out,
+ * which is 1 when b > a. Time complexity ~ O(na).
+ */
+static Limb subLimbs( Limb* const out, const Limb* const a, const size_t na, const Limb* const b, const size_t nb )
+{
+  Limb borrow { 0 };
+  size_t i { 0ULL };
+  for ( ; i < nb; ++i )
+  {
+    const WideLimb difference { WideLimb { a[i] } - b[i] - borrow };
+    out[i] = static_cast<Limb>(difference);
+    borrow = static_cast<Limb>(difference >> 63);
+  }
+  for ( ; i < na; ++i )
+  {
+    const WideLimb difference { WideLimb { a[i] } - borrow };
+    out[i] = static_cast<Limb>(difference);
+    borrow = static_cast<Limb>(difference >> 63);
+  }
+  return borrow;
+}
+
+/* out = a * b, overwriting the `na` + `nb` limbs of `out`, which must not overlap the operands.
+ * Every partial product and both carries fit in 64 bits : (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1.
+ * Time complexity ~ O(na * nb).
+ */
+static void schoolbookMultiply( const Limb* const a, const size_t na, const Limb* const b, const size_t nb,
+                                Limb* const out )
+{
+  std::fill( out, out + na + nb, Limb { 0 } );
+  for ( size_t i { 0ULL }; i < na; ++i )
+  {
+    const WideLimb scale { a[i] };
+    WideLimb carry { 0 };
+    for ( size_t j { 0ULL }; j < nb; ++j )
+    {
+      carry += scale * b[j] + out[i + j];
+      out[i + j] = static_cast<Limb>(carry);
+      carry >>= 32;
+    }
+    out[i + nb] = static_cast<Limb>(carry);
+  }
+}
+
+/* out = a^2, overwriting the 2n limbs of `out`. Every cross product a[i]*a[j] appears twice in the square, so only
+ * those with i < j are summed, the sum is doubled by a shift, and the squares a[i]^2 are added last.
+ * About half the multiplications of `schoolbookMultiply`. Time complexity ~ O(n^2).
+ */
+static void schoolbookSquare( const Limb* const a, const size_t n, Limb* const out )
+{
+  std::fill( out, out + 2 * n, Limb { 0 } );
+  for ( size_t i { 0ULL }; i < n; ++i )
+  {
+    const WideLimb scale { a[i] };
+    WideLimb carry { 0 };
+    for ( size_t j { i + 1 }; j < n; ++j )
+    {
+      carry += scale * a[j] + out[i + j];
+      out[i + j] = static_cast<Limb>(carry);
+      carry >>= 32;
+    }
+    out[i + n] = static_cast<Limb>(carry);
+  }
+
+  Limb shiftedOut { 0 };
+  for ( size_t i { 0ULL }; i < 2 * n; ++i )
+  {
+    const Limb limb { out[i] };
+    out[i] = (limb << 1) | shiftedOut;
+    shiftedOut = limb >> 31;
+  }
+
+  WideLimb carry { 0 };
+  for ( size_t i { 0ULL }; i < n; ++i )
+  {
+    const WideLimb square { WideLimb { a[i] } * a[i] };
+    carry += WideLimb { out[2 * i] } + static_cast<Limb>(square);
+    out[2 * i] = static_cast<Limb>(carry);
+    carry >>= 32;
+    carry += WideLimb { out[2 * i + 1] } + (square >> 32);
+    out[2 * i + 1] = static_cast<Limb>(carry);
+    carry >>= 32;
+  }
+}
+
+/* out = a * b for 2 operands of `n` limbs each, overwriting the 2n limbs of `out`.
+ * With a = a1*B + a0 and b = b1*B + b0 for B = 2^(32h), the middle term a0*b1 + a1*b0 is recovered as
+ * (a0 + a1)*(b0 + b1) - a0*b0 - a1*b1, so 3 half size products replace 4. The outer products are written
+ * straight into their final positions in `out`, only the middle one needs scratch space.
+ * When `a` and `b` are the same array, all 3 products are squares as well, down to `schoolbookSquare`.
+ * Time complexity ~ O(n^log2(3)) ~ O(n^1.585).
+ */
+static void karatsubaMultiply( const Limb* const a, const Limb* const b, const size_t n, Limb* const out )
+{
+  const bool square { a == b };
+  if ( n < karatsubaThreshold )
+  {
+    if ( square )
+      schoolbookSquare( a, n, out );
+    else
+      schoolbookMultiply( a, n, b, n, out );
+    return;
+  }
+
+  const size_t low { n / 2 };
+  const size_t high { n - low };                          // high >= low, sums of halves need high + 1 limbs
+  karatsubaMultiply( a, b, low, out );                    // a0*b0 into out[0, 2*low)
+  karatsubaMultiply( a + low, b + low, high, out + 2 * low );   // a1*b1 into out[2*low, 2n)
+
+  std::vector<Limb> scratch( 4 * (high + 1) );
+  Limb* const sumA { scratch.data() };
+  Limb* const sumB { sumA + high + 1 };
+  Limb* const middle { sumB + high + 1 };
+  sumA[high] = addLimbs( sumA, a + low, high, a, low );
+  if ( !square )
+    sumB[high] = addLimbs( sumB, b + low, high, b, low );
+  karatsubaMultiply( sumA, square ? sumA : sumB, high + 1, middle );
+
+  const size_t middleSize { 2 * (high + 1) };
+  subLimbs( middle, middle, middleSize, out, 2 * low );
+  subLimbs( middle, middle, middleSize, out + 2 * low, 2 * high );
+  // a0*b1 + a1*b0 < 2^(32n + 1), so the top limbs of `middle` beyond the space left in `out` are zero
+  addLimbs( out + low, out + low, 2 * n - low, middle, std::min( middleSize, 2 * n - low ) );
+}
+
+/* out = a * b for operands of any lengths, overwriting the `na` + `nb` limbs of `out`.
+ * Karatsuba needs operands of equal length, so the longer operand is cut into pieces as long as the shorter one,
+ * and the products of the pieces are added into `out` at their offsets.
+ */
+static void multiplyLimbs( const Limb* a, size_t na, const Limb* b, size_t nb, Limb* const out )
+{
+  if ( na < nb )
+  {
+    std::swap( a, b );
+    std::swap( na, nb );
+  }
+
+  if ( a == b && na == nb )
+    karatsubaMultiply( a, a, na, out );
+  else if ( nb < karatsubaThreshold )
+    schoolbookMultiply( a, na, b, nb, out );
+  else if ( na == nb )
+    karatsubaMultiply( a, b, na, out );
+  else
+  {
+    std::fill( out, out + na + nb, Limb { 0 } );
+    std::vector<Limb> piece( 2 * nb );
+    for ( size_t offset { 0ULL }; offset < na; offset += nb )
+    {
+      const size_t length { std::min( nb, na - offset ) };
+      multiplyLimbs( a + offset, length, b, nb, piece.data() );
+      addLimbs( out + offset, out + offset, na + nb - offset, piece.data(), length + nb );
+    }
+  }
+}
+
+////////// BigInteger //////////
+
+// Splits a 64 bit value into at most 2 limbs.
+BigInteger::BigInteger( const std::uint64_t value ) :
+  __limbs { static_cast<Limb>(value), static_cast<Limb>(value >> 32) }
+{
+  __trim();
+}
+
+void BigInteger::__trim()
+{
+  while ( !__limbs.empty() && __limbs.back() == 0 )
+    __limbs.pop_back();
+}
+
+bool BigInteger::isZero() const { return __limbs.empty(); }
+
+size_t BigInteger::bitLength() const
+{
+  if ( __limbs.empty() ) return 0;
+
+  size_t bits { 32 * (__limbs.size() - 1) };
+  for ( Limb top { __limbs.back() }; top; top >>= 1 )
+    ++bits;
+  return bits;
+}
+
+size_t BigInteger::limbs() const { return __limbs.size(); }
+
+std::uint64_t BigInteger::toUint64() const
+{
+  if ( __limbs.size() > 2 )
+    throw std::overflow_error { "error: BigInteger does not fit in 64 bits.\n" };
+
+  std::uint64_t value { 0 };
+  for ( size_t i { __limbs.size() }; i-- > 0; )
+    value = (value << 32) | __limbs[i];
+  return value;
+}
+
+/* Repeatedly divides a copy of the limbs by 10^9, the largest power of 10 that fits in a limb, and collects
+ * the remainders as groups of 9 decimal digits. Every division is a pass over all the limbs, so this is
+ * quadratic : fine for printing, but far slower than computing a Fibonacci number of the same size.
+ */
+std::string BigInteger::toString() const
+{
+  if ( __limbs.empty() ) return "0";
+
+  constexpr Limb chunk { 1'000'000'000 };
+  std::vector<Limb> quotient { __limbs };
+  std::string digits;
+  while ( !quotient.empty() )
+  {
+    WideLimb remainder { 0 };
+    for ( size_t i { quotient.size() }; i-- > 0; )
+    {
+      const WideLimb current { (remainder << 32) | quotient[i] };
+      quotient[i] = static_cast<Limb>(current / chunk);
+      remainder = current % chunk;
+    }
+    while ( !quotient.empty() && quotient.back() == 0 )
+      quotient.pop_back();
+
+    for ( int i { 0 }; i < 9 && (remainder || !quotient.empty()); ++i, remainder /= 10 )
+      digits.push_back( static_cast<char>('0' + remainder % 10) );
+  }
+
+  std::reverse( digits.begin(), digits.end() );
+  return digits;
+}
+
+// Time complexity ~ O(max(n1, n2)).
+BigInteger BigInteger::operator+( const BigInteger& other ) const
+{
+  const BigInteger& longer { __limbs.size() >= other.__limbs.size() ? *this : other };
+  const BigInteger& shorter { __limbs.size() >= other.__limbs.size() ? other : *this };
+
+  BigInteger result;
+  result.__limbs.resize( longer.__limbs.size() + 1 );
+  result.__limbs.back() = addLimbs( result.__limbs.data(), longer.__limbs.data(), longer.__limbs.size(),
+                                    shorter.__limbs.data(), shorter.__limbs.size() );
+  result.__trim();
+  return result;
+}
+
+// Adds in place, without a temporary. Time complexity ~ O(max(n1, n2)).
+void BigInteger::operator+=( const BigInteger& other )
+{
+  if ( __limbs.size() < other.__limbs.size() )
+    __limbs.resize( other.__limbs.size() );
+
+  const Limb carry { addLimbs( __limbs.data(), __limbs.data(), __limbs.size(), other.__limbs.data(),
+                               other.__limbs.size() ) };
+  if ( carry )
+    __limbs.push_back( carry );
+}
+
+// Time complexity ~ O(n1).
+BigInteger BigInteger::operator-( const BigInteger& other ) const
+{
+  BigInteger result { *this };
+  result -= other;
+  return result;
+}
+
+// Subtracts in place, throws before modifying anything if the result would be negative.
+void BigInteger::operator-=( const BigInteger& other )
+{
+  if ( *this < other )
+    throw std::underflow_error { "error: BigInteger subtraction result would be negative.\n" };
+
+  subLimbs( __limbs.data(), __limbs.data(), __limbs.size(), other.__limbs.data(), other.__limbs.size() );
+  __trim();
+}
+
+// Time complexity ~ O(n^1.585) for n limbs (see `karatsubaMultiply`).
+BigInteger BigInteger::operator*( const BigInteger& other ) const
+{
+  BigInteger result;
+  if ( isZero() || other.isZero() ) return result;
+
+  result.__limbs.resize( __limbs.size() + other.__limbs.size() );
+  multiplyLimbs( __limbs.data(), __limbs.size(), other.__limbs.data(), other.__limbs.size(), result.__limbs.data() );
+  result.__trim();
+  return result;
+}
+
+void BigInteger::operator*=( const BigInteger& other ) { *this = *this * other; }
+
+// Whole limbs are shifted by offsetting, the remaining bits by carrying across neighbouring limbs.
+BigInteger BigInteger::operator<<( const size_t bits ) const
+{
+  BigInteger result;
+  if ( isZero() ) return result;
+
+  const size_t limbShift { bits / 32 };
+  const unsigned bitShift { static_cast<unsigned>(bits % 32) };
+  result.__limbs.assign( __limbs.size() + limbShift + 1, 0 );
+  for ( size_t i { 0ULL }; i < __limbs.size(); ++i )
+  {
+    const WideLimb shifted { WideLimb { __limbs[i] } << bitShift };
+    result.__limbs[i + limbShift] |= static_cast<Limb>(shifted);
+    result.__limbs[i + limbShift + 1] = static_cast<Limb>(shifted >> 32);
+  }
+  result.__trim();
+  return result;
+}
+
+bool BigInteger::operator==( const BigInteger& other ) const { return __limbs == other.__limbs; }
+
+bool BigInteger::operator!=( const BigInteger& other ) const { return __limbs != other.__limbs; }
+
+// Without leading zero limbs, the longer number is the larger one, otherwise the highest differing limb decides.
+bool BigInteger::operator<( const BigInteger& other ) const
+{
+  if ( __limbs.size() != other.__limbs.size() )
+    return __limbs.size() < other.__limbs.size();
+
+  for ( size_t i { __limbs.size() }; i-- > 0; )
+    if ( __limbs[i] != other.__limbs[i] )
+      return __limbs[i] < other.__limbs[i];
+  return false;
+}
+
+bool BigInteger::operator<=( const BigInteger& other ) const { return !(other < *this); }
+
+bool BigInteger::operator>( const BigInteger& other ) const { return other < *this; }
+
+bool BigInteger::operator>=( const BigInteger& other ) const { return !(*this < other); }
+
+std::ostream& operator<<( std::ostream& out, const BigInteger& value ) { return out << value.toString(); }
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef __bigint_h__
+#define __bigint_h__
+
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uint32_t, std::uint64_t
+#include <ostream>          // std::ostream
+#include <string>           // std::string
+#include <vector>           // std::vector
+
+using size_t = std::size_t;
+
+/*///////////////////////////////////// Arbitrary precision non-negative integer //////////////////////////////////////
+ *
+ * The value is stored as base 2^32 digits (limbs), least significant first, with no leading zero limbs, so zero
+ * has no limbs at all. Limb products fit in 64 bits, so carries are propagated with plain 64 bit arithmetic.
+ * Multiplication is schoolbook for short operands and Karatsuba above a threshold : splitting both operands in
+ * halves, (a1*B + a0) * (b1*B + b0) needs only the 3 products a0*b0, a1*b1 and (a0 + a1)*(b0 + b1),
+ * so time complexity ~ O(n^1.585) instead of O(n^2), for n limbs.
+ * Only non-negative values are represented : a subtraction with a negative result throws `std::underflow_error`.
+ */
+class BigInteger
+{
+  std::vector<std::uint32_t> __limbs;                     // base 2^32 digits, least significant first
+
+  void __trim();                                          // drops leading zero limbs
+
+public:
+
+  BigInteger() = default;                                 // zero
+  BigInteger( const std::uint64_t value );                // implicit, so built-in integers mix with big ones
+
+  bool isZero() const;                                    // returns true for zero
+  size_t bitLength() const;                               // returns the number of significant bits (0 for zero)
+  size_t limbs() const;                                   // returns the number of base 2^32 digits
+  std::uint64_t toUint64() const;                         // throws `std::overflow_error` if the value does not fit
+  std::string toString() const;                           // decimal digits, time complexity ~ O(n^2)
+
+  BigInteger operator+( const BigInteger& other ) const;  // add 2 integers
+  void operator+=( const BigInteger& other );             // overloading shorthand operator (addition)
+  BigInteger operator-( const BigInteger& other ) const;  // subtract, throws if `other` is larger
+  void operator-=( const BigInteger& other );             // overloading shorthand operator (subtraction)
+  BigInteger operator*( const BigInteger& other ) const;  // multiply 2 integers (schoolbook or Karatsuba)
+  void operator*=( const BigInteger& other );             // overloading shorthand operator (multiplication)
+  BigInteger operator<<( const size_t bits ) const;       // multiply by 2^bits
+
+  bool operator==( const BigInteger& other ) const;
+  bool operator!=( const BigInteger& other ) const;
+  bool operator<( const BigInteger& other ) const;
+  bool operator<=( const BigInteger& other ) const;
+  bool operator>( const BigInteger& other ) const;
+  bool operator>=( const BigInteger& other ) const;
+};
+
+std::ostream& operator<<( std::ostream& out, const BigInteger& value );   // prints the decimal digits
+
+#endif
\ No newline at end of file
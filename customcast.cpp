@@ -0,0 +1,409 @@
+// Batch conversions between cartesian and polar coordinates, described in `customcast.h`
+
+#include "customcast.h"
+#include "policy.h"         // parallelBlocks
+
+#include <algorithm>        // std::max, std::min
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
+#include <iomanip>          // std::setw
+#include <random>           // std::mt19937_64, std::uniform_real_distribution
+#include <vector>           // std::vector
+
+// AVX2 implies FMA on every processor that has it, but GCC and Clang only allow the FMA intrinsics with -mfma
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define CAST_USE_AVX2
+#include <immintrin.h>      // _mm256_fmadd_pd, _mm256_sqrt_pd, _mm256_round_pd, _mm256_blendv_pd, ...
+#endif
+
+static constexpr size_t castBlock { 4096 };             // points per task of a threaded batch
+
+// Minimax coefficients of `ConversionMode::Fast`, in the forms of the Cephes ones below and on the same ranges :
+// sine within 1.8e-9, cosine within 9.6e-11 and arc tangent within 5e-9 radians, before rounding
+static constexpr double fastSinCoefficients[] { -1.9495636237884965e-4, 8.3319786631590783e-3, -1.6666650669294214e-1 };
+static constexpr double fastCosCoefficients[] { 2.4438451593104683e-5, -1.3887367515736982e-3, 4.1666646866442704e-2 };
+static constexpr double fastAtanCoefficients[] { 7.9025983737909408e-2, -1.3824453830255826e-1,
+                                                 1.9971879314762486e-1, -3.3332756669433017e-1 };
+
+// Horner's scheme
+template<size_t _Count>
+static double polynomial( const double x, const double ( &coefficients )[_Count] )
+{
+  double result { coefficients[0] };
+  for ( size_t i { 1 }; i < _Count; ++i )
+    result = result * x + coefficients[i];
+  return result;
+}
+
+// The one point versions of the fast polynomials, with the same reductions as the AVX2 kernels.
+void fast_sin_cos( const double degrees, double& sine, double& cosine )
+{
+  const double quadrant { std::nearbyint( degrees * (1.0 / 90.0) ) };
+  const double x { (degrees - 90.0 * quadrant) * (M_PI / 180.0) };
+  const double z { x * x };
+  const double s { x + x * z * polynomial( z, fastSinCoefficients ) };
+  const double c { 1.0 - 0.5 * z + z * z * polynomial( z, fastCosCoefficients ) };
+
+  // the quadrant modulo 4, as a double so that huge (or not finite) angles overflow nothing
+  const double turn { quadrant - 4.0 * std::floor( quadrant * 0.25 ) };
+  if ( turn == 1.0 )      { sine = c;  cosine = -s; }
+  else if ( turn == 2.0 ) { sine = -s; cosine = -c; }
+  else if ( turn == 3.0 ) { sine = -c; cosine = s; }
+  else                    { sine = s;  cosine = c; }
+}
+
+double fast_atan2( const double y, const double x )
+{
+  const double absoluteY { std::fabs( y ) }, absoluteX { std::fabs( x ) };
+  const double smaller { std::min( absoluteX, absoluteY ) }, larger { std::max( absoluteX, absoluteY ) };
+
+  // as in the AVX2 kernel : t in [-tan(pi/8), tan(pi/8)], then the pi/4 identity, the y axis and the negative x axis
+  const bool reduce { smaller > larger * 0.41421356237309504880 };
+  const double t { (larger == 0) ? 0.0 : reduce ? (smaller - larger) / (smaller + larger) : smaller / larger };
+  const double z { t * t };
+  double angle { t + t * z * polynomial( z, fastAtanCoefficients ) + (reduce ? M_PI / 4 : 0.0) };
+  if ( absoluteY > absoluteX ) angle = M_PI / 2 - angle;
+  if ( std::signbit( x ) ) angle = M_PI - angle;
+  return std::copysign( angle * (180.0 / M_PI), y );
+}
+
+#ifdef CAST_USE_AVX2
+
+// Cephes coefficients : sin(x) = x + x^3 * S(x^2), cos(x) = 1 - x^2 / 2 + x^4 * C(x^2), for |x| <= pi/4
+static constexpr double sinCoefficients[] { 1.58962301576546568060e-10, -2.50507477628578072866e-8,
+                                            2.75573136213857245213e-6, -1.98412698295895385996e-4,
+                                            8.33333333332211858878e-3, -1.66666666666666307295e-1 };
+static constexpr double cosCoefficients[] { -1.13585365213876817300e-11, 2.08757008419747316778e-9,
+                                            -2.75573141792967388112e-7, 2.48015872888517045348e-5,
+                                            -1.38888888888730564116e-3, 4.16666666666665929218e-2 };
+// Cephes coefficients : atan(x) = x + x^3 * P(x^2) / Q(x^2), for |x| <= tan(pi/8), Q monic
+static constexpr double atanNumerator[] { -8.750608600031904122785e-1, -1.615753718733365076637e1,
+                                          -7.500855792314704667340e1, -1.228866684490136173410e2,
+                                          -6.485021904942025371773e1 };
+static constexpr double atanDenominator[] { 1.0, 2.485846490142306297962e1, 1.650270098316988542046e2,
+                                            4.328810604912902668951e2, 4.853903996359136964868e2,
+                                            1.945506571482613964425e2 };
+
+// pi / 180, 180 / pi, pi / 4, pi / 2 and pi, each split into a double and the rounding error of that double
+static constexpr double radiansHigh { 1.7453292519943295e-2 }, radiansLow { 2.9486522708701687e-19 };
+static constexpr double degreesHigh { 57.29577951308232 }, degreesLow { -1.9878495670576283e-15 };
+static constexpr double quarterPiHigh { 0.7853981633974483 }, quarterPiLow { 3.061616997868383e-17 };
+static constexpr double halfPiHigh { 1.5707963267948966 }, halfPiLow { 6.123233995736766e-17 };
+static constexpr double piHigh { 3.141592653589793 }, piLow { 1.2246467991473532e-16 };
+
+// Horner's scheme, by fused multiply-adds
+template<size_t _Count>
+static __m256d polynomial( const __m256d x, const double ( &coefficients )[_Count] )
+{
+  __m256d result { _mm256_set1_pd( coefficients[0] ) };
+  for ( size_t i { 1 }; i < _Count; ++i )
+    result = _mm256_fmadd_pd( result, x, _mm256_set1_pd( coefficients[i] ) );
+  return result;
+}
+
+// (sin, cos) of 4 angles in degrees
+template<ConversionMode _Mode>
+static void sinCos( const __m256d degrees, __m256d& sine, __m256d& cosine )
+{
+  // degrees = 90 * quadrant + remainder, with |remainder| <= 45, exact up to the rounding of the result
+  const __m256d quadrant { _mm256_round_pd( _mm256_mul_pd( degrees, _mm256_set1_pd( 1.0 / 90.0 ) ),
+                                            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC ) };
+  const __m256d remainder { _mm256_fnmadd_pd( quadrant, _mm256_set1_pd( 90.0 ), degrees ) };
+  const __m256d x { _mm256_fmadd_pd( remainder, _mm256_set1_pd( radiansHigh ),
+                                     _mm256_mul_pd( remainder, _mm256_set1_pd( radiansLow ) ) ) };
+  const __m256d z { _mm256_mul_pd( x, x ) };
+
+  const __m256d sinTerm { (_Mode == ConversionMode::Exact) ? polynomial( z, sinCoefficients )
+                                                          : polynomial( z, fastSinCoefficients ) };
+  const __m256d cosTerm { (_Mode == ConversionMode::Exact) ? polynomial( z, cosCoefficients )
+                                                          : polynomial( z, fastCosCoefficients ) };
+  const __m256d s { _mm256_fmadd_pd( _mm256_mul_pd( x, z ), sinTerm, x ) };
+  const __m256d c { _mm256_fmadd_pd( _mm256_mul_pd( z, z ), cosTerm,
+                                     _mm256_fnmadd_pd( _mm256_set1_pd( 0.5 ), z, _mm256_set1_pd( 1.0 ) ) ) };
+
+  // adding 1.5 * 2^52 leaves the quadrant, as a two's complement integer, in the low bits of the double
+  const __m256i bits { _mm256_castpd_si256( _mm256_add_pd( quadrant, _mm256_set1_pd( 6755399441055744.0 ) ) ) };
+  const __m256i one { _mm256_set1_epi64x( 1 ) }, two { _mm256_set1_epi64x( 2 ) };
+  const __m256d swap { _mm256_castsi256_pd( _mm256_cmpeq_epi64( _mm256_and_si256( bits, one ), one ) ) };
+  const __m256d sineSign { _mm256_castsi256_pd( _mm256_slli_epi64( _mm256_and_si256( bits, two ), 62 ) ) };
+  const __m256d cosineSign { _mm256_castsi256_pd(
+    _mm256_slli_epi64( _mm256_and_si256( _mm256_add_epi64( bits, one ), two ), 62 ) ) };
+
+  // quadrant 1 : (cos, -sin), 2 : (-sin, -cos), 3 : (-cos, sin)
+  sine = _mm256_xor_pd( _mm256_blendv_pd( s, c, swap ), sineSign );
+  cosine = _mm256_xor_pd( _mm256_blendv_pd( c, s, swap ), cosineSign );
+}
+
+// atan2( y, x ) of 4 points, in degrees
+template<ConversionMode _Mode>
+static __m256d arcTangent( const __m256d y, const __m256d x )
+{
+  const __m256d signBit { _mm256_set1_pd( -0.0 ) }, zero { _mm256_setzero_pd() };
+  const __m256d absoluteY { _mm256_andnot_pd( signBit, y ) }, absoluteX { _mm256_andnot_pd( signBit, x ) };
+  const __m256d smaller { _mm256_min_pd( absoluteX, absoluteY ) }, larger { _mm256_max_pd( absoluteX, absoluteY ) };
+
+  // t = smaller / larger in [0, 1]; above tan(pi/8), atan(t) = pi/4 + atan((smaller - larger) / (smaller + larger))
+  const __m256d reduce { _mm256_cmp_pd( smaller, _mm256_mul_pd( larger, _mm256_set1_pd( 0.41421356237309504880 ) ),
+                                        _CMP_GT_OQ ) };
+  const __m256d numerator { _mm256_blendv_pd( smaller, _mm256_sub_pd( smaller, larger ), reduce ) };
+  const __m256d denominator { _mm256_blendv_pd( larger, _mm256_add_pd( smaller, larger ), reduce ) };
+  const __m256d t { _mm256_blendv_pd( _mm256_div_pd( numerator, denominator ), zero,
+                                      _mm256_cmp_pd( larger, zero, _CMP_EQ_OQ ) ) };   // atan2(0, 0) = 0
+  const __m256d z { _mm256_mul_pd( t, t ) };
+  const __m256d term { (_Mode == ConversionMode::Exact)
+    ? _mm256_div_pd( polynomial( z, atanNumerator ), polynomial( z, atanDenominator ) )
+    : polynomial( z, fastAtanCoefficients ) };
+  __m256d angle { _mm256_fmadd_pd( _mm256_mul_pd( t, z ), term, t ) };
+  angle = _mm256_add_pd( angle, _mm256_and_pd( reduce, _mm256_set1_pd( quarterPiLow ) ) );
+  angle = _mm256_add_pd( angle, _mm256_and_pd( reduce, _mm256_set1_pd( quarterPiHigh ) ) );
+
+  // |y| > |x| : the angle from the y axis, pi/2 - angle; x < 0 (or -0) : the angle from the negative x axis
+  const __m256d fromY { _mm256_cmp_pd( absoluteY, absoluteX, _CMP_GT_OQ ) };
+  angle = _mm256_blendv_pd( angle, _mm256_add_pd( _mm256_sub_pd( _mm256_set1_pd( halfPiHigh ), angle ),
+                                                  _mm256_set1_pd( halfPiLow ) ), fromY );
+  angle = _mm256_blendv_pd( angle, _mm256_add_pd( _mm256_sub_pd( _mm256_set1_pd( piHigh ), angle ),
+                                                  _mm256_set1_pd( piLow ) ), x );   // blends on the sign bit of x
+
+  // in degrees, then the sign of y, so that y = -0 gives -0 or -180 as with `std::atan2`
+  const __m256d degrees { _mm256_fmadd_pd( angle, _mm256_set1_pd( degreesHigh ),
+                                           _mm256_mul_pd( angle, _mm256_set1_pd( degreesLow ) ) ) };
+  return _mm256_or_pd( degrees, _mm256_and_pd( signBit, y ) );
+}
+
+/* Converts the points [first, last), 4 at a time. The last 1 to 3 points are copied into full registers, so every
+ * point goes through the same polynomials whatever its position in the batch.
+ */
+template<ConversionMode _Mode>
+static void toPolar( const double* const x, const double* const y, double* const r, double* const theta,
+                     const size_t first, const size_t last )
+{
+  size_t i { first };
+  for ( ; i + 4 <= last; i += 4 )
+  {
+    const __m256d px { _mm256_loadu_pd( x + i ) }, py { _mm256_loadu_pd( y + i ) };
+    _mm256_storeu_pd( r + i, _mm256_sqrt_pd( _mm256_fmadd_pd( px, px, _mm256_mul_pd( py, py ) ) ) );
+    _mm256_storeu_pd( theta + i, arcTangent<_Mode>( py, px ) );
+  }
+  if ( i < last )
+  {
+    alignas( 32 ) double bufferX[4] { }, bufferY[4] { }, bufferR[4], bufferTheta[4];
+    std::copy( x + i, x + last, bufferX );
+    std::copy( y + i, y + last, bufferY );
+    toPolar<_Mode>( bufferX, bufferY, bufferR, bufferTheta, 0, 4 );
+    std::copy( bufferR, bufferR + (last - i), r + i );
+    std::copy( bufferTheta, bufferTheta + (last - i), theta + i );
+  }
+}
+
+template<ConversionMode _Mode>
+static void toCartesian( const double* const r, const double* const theta, double* const x, double* const y,
+                         const size_t first, const size_t last )
+{
+  size_t i { first };
+  for ( ; i + 4 <= last; i += 4 )
+  {
+    const __m256d radius { _mm256_loadu_pd( r + i ) };
+    __m256d sine, cosine;
+    sinCos<_Mode>( _mm256_loadu_pd( theta + i ), sine, cosine );
+    _mm256_storeu_pd( x + i, _mm256_mul_pd( radius, cosine ) );
+    _mm256_storeu_pd( y + i, _mm256_mul_pd( radius, sine ) );
+  }
+  if ( i < last )
+  {
+    alignas( 32 ) double bufferR[4] { }, bufferTheta[4] { }, bufferX[4], bufferY[4];
+    std::copy( r + i, r + last, bufferR );
+    std::copy( theta + i, theta + last, bufferTheta );
+    toCartesian<_Mode>( bufferR, bufferTheta, bufferX, bufferY, 0, 4 );
+    std::copy( bufferX, bufferX + (last - i), x + i );
+    std::copy( bufferY, bufferY + (last - i), y + i );
+  }
+}
+
+#else
+
+// the same conversions as `cartesian::toPolar` and `polar::toCartesian`, one point at a time
+template<ConversionMode _Mode>
+static void toPolar( const double* const x, const double* const y, double* const r, double* const theta,
+                     const size_t first, const size_t last )
+{
+  for ( size_t i { first }; i < last; ++i )
+  {
+    r[i] = std::sqrt( x[i] * x[i] + y[i] * y[i] );
+    theta[i] = (_Mode == ConversionMode::Exact) ? std::atan2( y[i], x[i] ) * (180.0 / M_PI) : fast_atan2( y[i], x[i] );
+  }
+}
+
+template<ConversionMode _Mode>
+static void toCartesian( const double* const r, const double* const theta, double* const x, double* const y,
+                         const size_t first, const size_t last )
+{
+  for ( size_t i { first }; i < last; ++i )
+  {
+    double sine, cosine;
+    if ( _Mode == ConversionMode::Exact )
+    {
+      sine = std::sin( theta[i] * (M_PI / 180.0) );
+      cosine = std::cos( theta[i] * (M_PI / 180.0) );
+    }
+    else
+      fast_sin_cos( theta[i], sine, cosine );
+    x[i] = r[i] * cosine;
+    y[i] = r[i] * sine;
+  }
+}
+
+#endif
+
+// Runs `convert` on blocks of `castBlock` points across `pool`, or on the whole batch for small ones.
+template<typename _Convert>
+static void convertBatch( const size_t count, ThreadPool& pool, const _Convert convert )
+{
+  if ( count <= (1 << 16) || pool.threads() == 1 )
+    convert( 0, count );
+  else
+    parallelBlocks( count, castBlock, convert, pool );
+}
+
+void cartesian_to_polar( const double* const x, const double* const y, double* const r, double* const theta,
+                         const size_t count, const ConversionMode mode, ThreadPool& pool )
+{
+  if ( mode == ConversionMode::Fast )
+    convertBatch( count, pool, [=] ( const size_t first, const size_t last )
+    {
+      toPolar<ConversionMode::Fast>( x, y, r, theta, first, last );
+    } );
+  else
+    convertBatch( count, pool, [=] ( const size_t first, const size_t last )
+    {
+      toPolar<ConversionMode::Exact>( x, y, r, theta, first, last );
+    } );
+}
+
+void polar_to_cartesian( const double* const r, const double* const theta, double* const x, double* const y,
+                         const size_t count, const ConversionMode mode, ThreadPool& pool )
+{
+  if ( mode == ConversionMode::Fast )
+    convertBatch( count, pool, [=] ( const size_t first, const size_t last )
+    {
+      toCartesian<ConversionMode::Fast>( r, theta, x, y, first, last );
+    } );
+  else
+    convertBatch( count, pool, [=] ( const size_t first, const size_t last )
+    {
+      toCartesian<ConversionMode::Exact>( r, theta, x, y, first, last );
+    } );
+}
+
+
+// Largest difference from `exact`, in units of the last place of the exact value.
+static double ulpError( const double value, const long double exact )
+{
+  if ( exact == 0 ) return value == 0 ? 0 : 1e300;
+  const double rounded { static_cast<double>(exact) };
+  const double ulp { std::nextafter( std::fabs( rounded ), INFINITY ) - std::fabs( rounded ) };
+  return static_cast<double>(std::fabs( value - exact ) / ulp);
+}
+
+/* Checks the batches of both modes against `long double` evaluations over random points in every quadrant (and
+ * the axes) : the exact ones in units of the last place, the fast ones in degrees and in fractions of the radius,
+ * as documented with `ConversionMode`. Also checks the one point conversions against the batches. Then times 2^22
+ * points through the classes, one at a time, against the batches on 1 thread and on the shared pool, in both modes.
+ */
+void testBatchCast()
+{
+  constexpr size_t count { 1 << 22 };
+  constexpr ConversionMode modes[] { ConversionMode::Exact, ConversionMode::Fast };
+  const auto modeName { [] ( const ConversionMode mode ) { return (mode == ConversionMode::Exact) ? "exact" : "fast"; } };
+  std::mt19937_64 generator { 2021 };
+  std::uniform_real_distribution<double> coordinate { -1000.0, 1000.0 }, angle { -720.0, 720.0 };
+
+  std::vector<double> x( count ), y( count ), r( count ), theta( count ), backX( count ), backY( count );
+  for ( size_t i { 0 }; i < count; ++i )
+  {
+    x[i] = (i % 1000 == 0) ? 0.0 : coordinate( generator );
+    y[i] = (i % 1000 == 500) ? 0.0 : coordinate( generator );
+  }
+  std::vector<double> angles( count );
+  for ( auto& value : angles )
+    value = angle( generator );
+
+  const long double pi { 3.141592653589793238462643383279502884L };
+  for ( const ConversionMode mode : modes )
+  {
+    cartesian_to_polar( x.data(), y.data(), r.data(), theta.data(), count, mode );
+    double radiusError { 0 }, angleError { 0 }, classError { 0 };
+    for ( size_t i { 0 }; i < count; i += 16 )
+    {
+      const long double lx { x[i] }, ly { y[i] };
+      const long double exactAngle { std::atan2( ly, lx ) * 180 / pi };
+      radiusError = std::max( radiusError, ulpError( r[i], std::sqrt( lx * lx + ly * ly ) ) );
+      angleError = std::max( angleError, (mode == ConversionMode::Exact) ? ulpError( theta[i], exactAngle )
+                                                                         : static_cast<double>(std::fabs( theta[i] - exactAngle )) );
+      const polar point { cartesian { x[i], y[i] }.toPolar( mode ) };
+      classError = std::max( classError, std::fabs( point.theta() - theta[i] ) );
+    }
+    std::cout << modeName( mode ) << " cartesian to polar : radius within " << radiusError << " ulp, angle within "
+      << angleError << ((mode == ConversionMode::Exact) ? " ulp" : " degrees") << ", `toPolar` within " << classError
+      << " degrees of the batch\n";
+
+    polar_to_cartesian( r.data(), angles.data(), backX.data(), backY.data(), count, mode );
+    double coordinateError { 0 };
+    for ( size_t i { 0 }; i < count; i += 16 )
+    {
+      const long double radians { angles[i] * pi / 180 };
+      const long double exactX { r[i] * std::cos( radians ) }, exactY { r[i] * std::sin( radians ) };
+      // relative to the radius : the absolute error of a coordinate near 0 is what matters for a point
+      coordinateError = std::max( { coordinateError, static_cast<double>(std::fabs( backX[i] - exactX ) / r[i]),
+                                    static_cast<double>(std::fabs( backY[i] - exactY ) / r[i]) } );
+    }
+    std::cout << modeName( mode ) << " polar to cartesian : coordinates within " << coordinateError << " of the radius\n";
+  }
+
+  const auto time { [] ( const auto& run )
+  {
+    const auto start { std::chrono::steady_clock::now() };
+    run();
+    const std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+    return count / elapsed.count() / 1e6;
+  } };
+  ThreadPool single { 1 };
+  std::cout << std::setw( 22 ) << "M points/s" << std::setw( 8 ) << "mode" << std::setw( 12 ) << "classes"
+    << std::setw( 12 ) << "batch" << std::setw( 10 ) << "threads" << std::setw( 12 ) << "batch" << '\n';
+  for ( const ConversionMode mode : modes )
+  {
+    const double classToPolar { time( [&]
+    {
+      for ( size_t i { 0 }; i < count; ++i )
+      {
+        const polar point { cartesian { x[i], y[i] }.toPolar( mode ) };
+        r[i] = point.r();
+        theta[i] = point.theta();
+      }
+    } ) };
+    const double batchToPolar { time( [&] { cartesian_to_polar( x.data(), y.data(), r.data(), theta.data(), count, mode, single ); } ) };
+    const double sharedToPolar { time( [&] { cartesian_to_polar( x.data(), y.data(), r.data(), theta.data(), count, mode ); } ) };
+    std::cout << std::setw( 22 ) << "cartesian to polar" << std::setw( 8 ) << modeName( mode ) << std::setw( 12 ) << classToPolar
+      << std::setw( 12 ) << batchToPolar << std::setw( 10 ) << ThreadPool::shared().threads() << std::setw( 12 ) << sharedToPolar << '\n';
+  }
+  for ( const ConversionMode mode : modes )
+  {
+    const double classToCartesian { time( [&]
+    {
+      for ( size_t i { 0 }; i < count; ++i )
+      {
+        const cartesian point { polar { r[i], angles[i] }.toCartesian( mode ) };
+        backX[i] = point.x();
+        backY[i] = point.y();
+      }
+    } ) };
+    const double batchToCartesian { time( [&]
+    {
+      polar_to_cartesian( r.data(), angles.data(), backX.data(), backY.data(), count, mode, single );
+    } ) };
+    const double sharedToCartesian { time( [&]
+    {
+      polar_to_cartesian( r.data(), angles.data(), backX.data(), backY.data(), count, mode );
+    } ) };
+    std::cout << std::setw( 22 ) << "polar to cartesian" << std::setw( 8 ) << modeName( mode ) << std::setw( 12 ) << classToCartesian
+      << std::setw( 12 ) << batchToCartesian << std::setw( 10 ) << ThreadPool::shared().threads() << std::setw( 12 ) << sharedToCartesian << '\n';
+  }
+}
@@ -1,9 +1,28 @@
 // test casting between 2 user-defined classes using overloading
 
-#define _USE_MATH_DEFINES
+#ifndef __customcast_h__
+#define __customcast_h__
+
+#define _USE_MATH_DEFINES   // M_PI from <cmath> on MSVC, so before any include that may include it
+#include "parallel.h"       // ThreadPool
+
 #include <cmath>
+#include <cstddef>          // std::size_t
 #include <iostream>         // std::cout
 
+using size_t = std::size_t;
+
+/* How the conversions evaluate sine, cosine and arc tangent :
+ * - Exact : as accurate as the standard library (or within a few units in the last place, for the batches)
+ * - Fast : lower degree minimax polynomials on the same reduced ranges, about half the arithmetic, for rendering
+ *   and bucketing. Angles are within 3e-7 degrees of the exact ones, and coordinates within 2e-9 times the radius
+ *   of the exact ones. Radii are computed the same way in both modes.
+ */
+enum class ConversionMode { Exact, Fast };
+
+void fast_sin_cos( double degrees, double& sine, double& cosine ); // approximations of `ConversionMode::Fast`
+double fast_atan2( double y, double x );                  // in degrees, in [-180, 180] with the signs of `std::atan2`
+
 class polar;
 
 class cartesian // cartesian coordinates
@@ -18,6 +37,9 @@ public:
     __y { y }
   { }
   operator polar() const;
+  polar toPolar( ConversionMode mode = ConversionMode::Exact ) const;
+  double x() const { return __x; }
+  double y() const { return __y; }
   void view() const { std::cout << "Cartesian : ( " << __x << ' ' << __y << " )\n"; }
 };
 
@@ -40,13 +62,17 @@ public:
   {
     return cartesian { __r * std::cos( __th * M_PI / 180.0 ), __r * std::sin( __th * M_PI / 180.0 ) };
   }
+  cartesian toCartesian( ConversionMode mode = ConversionMode::Exact ) const;
+  double r() const { return __r; }
+  double theta() const { return __th; }                   // degrees
   void view() const { std::cout << "Polar : ( " << __r << ' ' << __th << "\370 )\n"; }  // 370 is code for degree symbol
 };
 
+// `std::atan2` takes the signs of both coordinates into account, so the angle is in the right quadrant, in (-180, 180]
 inline
 cartesian::operator polar() const
 {
-  auto theta { (__x == 0) ? M_PI_2 * ((__y > 0) - (0 > __y)) : std::atan( __y / __x ) };
+  const double theta { std::atan2( __y, __x ) };
   return polar
   {
     std::sqrt( __x * __x + __y * __y ),
@@ -54,6 +80,22 @@ cartesian::operator polar() const
   };
 }
 
+inline
+polar cartesian::toPolar( const ConversionMode mode ) const
+{
+  if ( mode == ConversionMode::Exact ) return static_cast<polar>(*this);
+  return polar { std::sqrt( __x * __x + __y * __y ), fast_atan2( __y, __x ) };
+}
+
+inline
+cartesian polar::toCartesian( const ConversionMode mode ) const
+{
+  if ( mode == ConversionMode::Exact ) return static_cast<cartesian>(*this);
+  double sine, cosine;
+  fast_sin_cos( __th, sine, cosine );
+  return cartesian { __r * cosine, __r * sine };
+}
+
 inline
 void testCustomCast()
 {
@@ -67,3 +109,28 @@ void testCustomCast()
   point = static_cast<cartesian>(point2);
   point.view();
 }
+
+/*////////////////////////////////// Batch conversions of point clouds //////////////////////////////////
+ *
+ * Structure of arrays : every coordinate has its own array, so 4 points fill one AVX2 register per coordinate, with
+ * no shuffling. Angles are in degrees, as in `polar`. With AVX2 and FMA, sine, cosine and arc tangent are evaluated
+ * by polynomials 4 points at a time :
+ * - sine and cosine reduce the angle by the nearest multiple of 90 degrees (exactly, with no multiple of pi), then
+ *   use the Cephes polynomials on [-pi/4, pi/4], and swap or negate them by quadrant
+ * - arc tangent reduces |y| / |x| (or its inverse) to [0, 1], then below tan(pi/8) with the pi/4 identity, and uses
+ *   the Cephes rational approximation, before restoring the quadrant from the signs as `std::atan2` does
+ * Both are within a few units in the last place of the exact values, for finite coordinates. The projects build
+ * with /arch:AVX2, and other builds need -mavx2 -mfma. Without AVX2, every point goes through the standard library
+ * functions. `ConversionMode::Fast` swaps in its shorter polynomials
+ * (and drops the division of the rational arc tangent), with or without AVX2.
+ * Batches of more than 2^16 points are converted in blocks across `pool`, by `parallelBlocks`.
+ * Input and output arrays must not overlap.
+ */
+void cartesian_to_polar( const double* x, const double* y, double* r, double* theta, size_t count,
+                         ConversionMode mode = ConversionMode::Exact, ThreadPool& pool = ThreadPool::shared() );
+void polar_to_cartesian( const double* r, const double* theta, double* x, double* y, size_t count,
+                         ConversionMode mode = ConversionMode::Exact, ThreadPool& pool = ThreadPool::shared() );
+
+void testBatchCast();                                     // accuracy against `long double` and benchmark of both modes
+
+#endif
\ No newline at end of file
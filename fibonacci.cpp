@@ -1,49 +1,69 @@
 // Implementations of algorithms described in `fibonacci.h`
 
 #include "fibonacci.h"
-#include "structs.h"        // Matrix
+#include "memocache.h"      // MemoCache
+#include "modular.h"        // Montgomery64, multiplyMod
+#include "smallmatrix.h"    // SmallMatrix
+#include "trace.h"          // TRACE_SCOPE, TRACE_MOVED
 
+#include <algorithm>        // std::fill, std::find, std::max, std::min, std::min_element, std::nth_element
+#include <atomic>           // std::atomic, std::memory_order_acquire, std::memory_order_release
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
+#include <fstream>          // std::ifstream, std::ofstream
+#include <iomanip>          // std::setw
 #include <iostream>         // std::cout
+#include <iterator>         // std::begin, std::end, std::size
+#include <limits>           // std::numeric_limits
+#include <mutex>            // std::call_once, std::once_flag
+#include <numeric>          // std::gcd
+#include <optional>         // std::optional
+#include <random>           // std::mt19937_64, std::uniform_int_distribution
+#include <stdexcept>        // std::invalid_argument, std::out_of_range
+#include <string>           // std::string
+#include <thread>           // std::thread
+#include <utility>          // std::move, std::pair, std::swap
 #include <vector>           // std::vector
 
+// store the calculated values of the fibonacci series, shared by all threads (one cache per function)
+static MemoCache<int> rdpSeries;
+static MemoCache<int> idpSeries;
+static MemoCache<int> fdSeries;
+
 int fibonacci_rdp( size_t count )  // exponential time
 {
-  // stores the calculated values of the fibonacci series
-  static std::vector<int> series { 0, 1 };
-
-  // if value has not been calculated previously, add it
-  if ( count >= series.size() )
-    series.push_back(
-      fibonacci_rdp( count - 1 ) +
-      fibonacci_rdp( count - 2 )
-    );
+  if ( count < 2 ) return static_cast<int>(count);
 
-  return series[count];
+  // if value has not been calculated previously, calculate and store it
+  return rdpSeries.getOrCompute( count, [count] { return fibonacci_rdp( count - 1 ) + fibonacci_rdp( count - 2 ); } );
 }
 
-// commented code for non-memoized algorithm
 int fibonacci_idp( size_t count )  // linear time
 {
-  // if ( count == 0 ) return 0;
-  // stores the calculated values of the fibonacci series
-  static std::vector<int> series { 0, 1 };
+  auto known = [] ( const size_t index )
+  {
+    return index < 2 ? std::optional<int> { static_cast<int>(index) } : idpSeries.find( index );
+  };
 
-  // int A { 0 };
-  // int B { 1 };
+  std::optional<int> A, B { known( count ) };
+  if ( B ) return *B;
 
-  // iteratively calculate fibonacci series, if not in stored vector
-  auto N { series.size() };
-  while ( count >= N ) // ( --count )
+  // walk back to the last 2 consecutive values already calculated (F(0) and F(1) always are)
+  size_t N { count };
+  do
+    --N;
+  while ( !(B = known( N )) || !(A = known( N - 1 )) );
+
+  // iteratively calculate the rest of the fibonacci series up to `count`, storing every value
+  int previous { *A }, current { *B };
+  for ( ; N < count; ++N )
   {
-    series.push_back(
-      series[N - 1] + series[N - 2]
-    );
-    ++N;
-    // B = A + B;
-    // A = B - A;
+    const int next { previous + current };
+    idpSeries.insert( N + 1, next );
+    previous = current;
+    current = next;
   }
 
-  return series[count]; // B;
+  return current;
 }
 
 int fibonacci_mat( size_t count )
@@ -51,27 +71,15 @@ int fibonacci_mat( size_t count )
   // return count as is for 0, 1
   if ( count < 2 ) return static_cast<int>(count);
 
+  // fixed-size matrices live on the stack, so the exponentiation does no heap allocation
   // array that contains the fibonacci matrix to be exponentiated
-  Matrix<int> M { 2, 2, {
+  constexpr SmallMatrix<int, 2, 2> M {
     { 1, 1 },
     { 1, 0 }
-  } };
-
-  // array that contains the result matrix
-  Matrix<int> R { 2, 2, {
-    { 1, 0 },
-    { 0, 1 }
-  } };
-
-  --count;                // Fibonacci(count) = (M ^ count-1)[0][0]
-  while ( count )         // exponentiate M to count, but in log(count) time
-  {                       // using exponentiation by squaring algorithm
-    if ( count & 1 )
-      R *= M;
+  };
 
-    count >>= 1;
-    M *= M;
-  }
+  // Fibonacci(count) = (M ^ count-1)[0][0], exponentiated in log(count) time by squaring
+  const auto R { power( M, count - 1 ) };
 
   // first element is required fibonacci number
   return R[0][0];
@@ -80,26 +88,546 @@ int fibonacci_mat( size_t count )
 /* Calculate recursively fibonacci series, with memoization
  * F(2k) = F(k)^2 + 2*F(k)*F(k-1), even doubling
  * F(2k+1) = F(k)^2 + F(k+1)^2, odd doubling
+ * Only the O(log(count)) indices reached by halving are calculated, so the memo holds sparse keys.
  */
 int fibonacci_fd( size_t count )
 {
-  // stores the calculated values of the fibonacci series
-  static std::vector<int> series { 0, 1 };
+  if ( count < 2 ) return static_cast<int>(count);
 
-  // if value has not been calculated previously, add it
-  if ( count >= series.size() )
+  // if value has not been calculated previously, calculate and store it
+  return fdSeries.getOrCompute( count, [count]
   {
-    size_t k = count >> 1;
-    series.push_back(
-      // doubling formula obtained from fibonacci series
-      fibonacci_fd( k ) * fibonacci_fd( k ) +
+    const size_t k { count >> 1 };
+    const int half { fibonacci_fd( k ) };
+    // doubling formula obtained from fibonacci series
+    return half * half +
       (count & 1
         ? fibonacci_fd( k + 1 ) * fibonacci_fd( k + 1 )
-        : fibonacci_fd( k ) * fibonacci_fd( k - 1 ) << 1)
-    );
+        : 2 * half * fibonacci_fd( k - 1 ));
+  } );
+}
+
+////////// Choosing between the int functions //////////
+
+int fibonacci_call( const FibonacciMethod method, const size_t count )
+{
+  switch ( method )
+  {
+  case FibonacciMethod::RDP: return fibonacci_rdp( count );
+  case FibonacciMethod::IDP: return fibonacci_idp( count );
+  case FibonacciMethod::MAT: return fibonacci_mat( count );
+  case FibonacciMethod::FD: return fibonacci_fd( count );
+  }
+  throw std::invalid_argument { "error: unknown fibonacci method.\n" };
+}
+
+void fibonacci_clear_caches()
+{
+  rdpSeries.clear();
+  idpSeries.clear();
+  fdSeries.clear();
+}
+
+double fibonacci_latency( const FibonacciMethod method, const size_t count, const bool cold, const size_t trials )
+{
+  if ( trials == 0 )
+    throw std::invalid_argument { "error: latency needs at least 1 trial.\n" };
+
+  volatile size_t index { count };                        // read every call, so no call is hoisted out of a loop
+  volatile int sink { 0 };
+  if ( cold )
+  {
+    std::vector<double> samples( trials );
+    for ( auto& sample : samples )
+    {
+      fibonacci_clear_caches();
+      const auto start { std::chrono::steady_clock::now() };
+      sink = fibonacci_call( method, index );
+      const std::chrono::duration<double, std::nano> elapsed { std::chrono::steady_clock::now() - start };
+      sample = elapsed.count();
+    }
+    static_cast<void>(sink);                              // the stores are the point, but the variable must be read
+    std::nth_element( samples.begin(), samples.begin() + trials / 2, samples.end() );
+    return samples[trials / 2];
+  }
+
+  sink = fibonacci_call( method, index );                 // fills the cache
+  const auto start { std::chrono::steady_clock::now() };
+  for ( size_t i { 0 }; i < trials; ++i )
+    sink = fibonacci_call( method, index );
+  const std::chrono::duration<double, std::nano> elapsed { std::chrono::steady_clock::now() - start };
+  static_cast<void>(sink);
+  return elapsed.count() / trials;
+}
+
+static constexpr size_t autoCounts { 47 };                // F(0) to F(46), every value that fits in `int`
+static constexpr const char* methodNames[] { "RDP", "IDP", "MAT", "FD" };
+static constexpr FibonacciMethod methods[] { FibonacciMethod::RDP, FibonacciMethod::IDP, FibonacciMethod::MAT,
+                                             FibonacciMethod::FD };
+
+static std::once_flag calibrated;
+static std::atomic<bool> isCalibrated { false };          // set (release) once `fastestMethod` is filled
+static FibonacciMethod fastestMethod[autoCounts];         // filled once under `calibrated`, read-only afterwards
+
+// crossovers in the format of the cache file : one "first method" line each, from first = 0, increasing
+static bool loadCrossovers( const std::string& cacheFile, std::vector<FibonacciCrossover>& crossovers )
+{
+  std::ifstream file { cacheFile };
+  std::string name;
+  for ( size_t first; file >> first >> name; )
+  {
+    const auto found { std::find( std::begin( methodNames ), std::end( methodNames ), name ) };
+    if ( found == std::end( methodNames ) || first >= autoCounts
+         || (crossovers.empty() ? first != 0 : first <= crossovers.back().first) )
+      return false;
+    crossovers.push_back( { first, methods[found - std::begin( methodNames )] } );
+  }
+  return file.eof() && !crossovers.empty();
+}
+
+/* Every count goes to the method with the lowest warm latency (the median of 5 loops, to be robust to
+ * interruptions), and runs of counts with the same method become crossovers. The method of the previous count
+ * is kept unless another one is more than 15% faster : the memoized methods are all a cache lookup once warm,
+ * and switching between them on noise alone would only add branch mispredictions and cold caches.
+ */
+static std::vector<FibonacciCrossover> measureCrossovers()
+{
+  std::vector<FibonacciCrossover> crossovers;
+  for ( size_t count { 0 }; count < autoCounts; ++count )
+  {
+    double times[std::size( methods )];
+    for ( size_t m { 0 }; m < std::size( methods ); ++m )
+    {
+      double samples[5];
+      for ( auto& sample : samples )
+        sample = fibonacci_latency( methods[m], count, false, 200 );
+      std::nth_element( samples, samples + 2, samples + 5 );
+      times[m] = samples[2];
+    }
+
+    const size_t fastest { static_cast<size_t>(std::min_element( times, times + std::size( methods ) ) - times) };
+    if ( crossovers.empty() )
+      crossovers.push_back( { count, methods[fastest] } );
+    else if ( times[fastest] * 1.15 < times[static_cast<int>(crossovers.back().method)] )
+      crossovers.push_back( { count, methods[fastest] } );
+  }
+  return crossovers;
+}
+
+// loads or measures the crossovers, and fills `fastestMethod` from them; only ever called under `calibrated`
+static void calibrate( const std::string& cacheFile )
+{
+  TRACE_SCOPE( "fibonacci_calibrate" );
+  std::vector<FibonacciCrossover> crossovers;
+  if ( cacheFile.empty() || !loadCrossovers( cacheFile, crossovers ) )
+  {
+    crossovers = measureCrossovers();
+    if ( !cacheFile.empty() )
+    {
+      std::ofstream file { cacheFile };
+      for ( const auto& crossover : crossovers )
+        file << crossover.first << ' ' << methodNames[static_cast<int>(crossover.method)] << '\n';
+    }
+  }
+
+  for ( size_t i { 0 }; i < crossovers.size(); ++i )
+    std::fill( fastestMethod + crossovers[i].first,
+               fastestMethod + (i + 1 < crossovers.size() ? crossovers[i + 1].first : autoCounts),
+               crossovers[i].method );
+  isCalibrated.store( true, std::memory_order_release );
+}
+
+std::vector<FibonacciCrossover> fibonacci_calibrate( const std::string& cacheFile )
+{
+  std::call_once( calibrated, calibrate, cacheFile );
+
+  // rebuilt from the table, so later callers see the crossovers in use whatever file they name
+  std::vector<FibonacciCrossover> crossovers;
+  for ( size_t count { 0 }; count < autoCounts; ++count )
+    if ( crossovers.empty() || crossovers.back().method != fastestMethod[count] )
+      crossovers.push_back( { count, fastestMethod[count] } );
+  return crossovers;
+}
+
+// larger counts overflow `int` with every method, and go to the method of the largest calibrated count
+int fibonacci_auto( const size_t count )
+{
+  if ( !isCalibrated.load( std::memory_order_acquire ) )   // skips the call to `std::call_once` once calibrated
+    std::call_once( calibrated, calibrate, std::string { } );
+  return fibonacci_call( fastestMethod[std::min( count, autoCounts - 1 )], count );
+}
+
+/* Walks the bits of `count` from the highest, keeping (a, b) = (F(k), F(k+1)) for the prefix k of those bits.
+ * Appending a bit doubles k, using the same relations as `fibonacci_fd` in the form
+ * F(2k) = F(k) * (2*F(k+1) - F(k)), F(2k+1) = F(k)^2 + F(k+1)^2, and a set bit moves one step further.
+ * That is 3 multiplications per bit, and the numbers double in size every bit, so the total time is dominated by
+ * the last few steps : time complexity ~ O(M(n)) where M(n) is the cost of multiplying numbers of n bits.
+ * The last step only computes the one value that is returned.
+ */
+BigInteger fibonacci_big( size_t count )
+{
+  TRACE_SCOPE( "fibonacci_big" );
+  if ( count == 0 ) return BigInteger { };
+
+  size_t mask { 1 };
+  while ( mask <= count >> 1 )
+    mask <<= 1;
+
+  BigInteger a { 0 }, b { 1 };
+  for ( ; mask > 1; mask >>= 1 )
+  {
+    BigInteger even { a * ((b << 1) - a) };               // F(2k)
+    BigInteger odd { a * a + b * b };                     // F(2k+1)
+    if ( count & mask )
+    {
+      b = even + odd;                                     // F(2k+2)
+      a = std::move( odd );
+    }
+    else
+    {
+      a = std::move( even );
+      b = std::move( odd );
+    }
+  }
+
+  return (count & 1) ? a * a + b * b : a * ((b << 1) - a);
+}
+
+// the tables are complete and exact : the last entries are the largest fibonacci numbers below 2^32, 2^64, 2^128
+static_assert( FibonacciTable<std::uint32_t>::size == 48 && fibonacci_table<std::uint32_t>( 47 ) == 2'971'215'073U );
+static_assert( FibonacciTable<std::uint64_t>::size == 94
+               && fibonacci_table<std::uint64_t>( 93 ) == 12'200'160'415'121'876'738ULL );
+#if defined(__SIZEOF_INT128__)
+static_assert( FibonacciTable<unsigned __int128>::size == 187 );
+#endif
+
+BigInteger fibonacci( const size_t count )
+{
+#if defined(__SIZEOF_INT128__)
+  if ( count < FibonacciTable<unsigned __int128>::size )
+  {
+    const unsigned __int128 value { fibonacciTable<unsigned __int128>.values[count] };
+    return (BigInteger { static_cast<std::uint64_t>(value >> 64) } << 64) + static_cast<std::uint64_t>(value);
+  }
+#else
+  if ( count < FibonacciTable<std::uint64_t>::size )
+    return fibonacciTable<std::uint64_t>.values[count];
+#endif
+
+  return fibonacci_big( count );
+}
+
+////////// Fibonacci numbers modulo m //////////
+
+// Prime factorization by trial division, as (prime, exponent) pairs. Time complexity ~ O(sqrt(value)).
+static std::vector<std::pair<std::uint64_t, unsigned>> factorize( std::uint64_t value )
+{
+  std::vector<std::pair<std::uint64_t, unsigned>> factors;
+  for ( std::uint64_t divisor { 2 }; divisor * divisor <= value; divisor += (divisor == 2) ? 1 : 2 )
+    if ( value % divisor == 0 )
+    {
+      unsigned exponent { 0 };
+      for ( ; value % divisor == 0; value /= divisor )
+        ++exponent;
+      factors.emplace_back( divisor, exponent );
+    }
+  if ( value > 1 )
+    factors.emplace_back( value, 1 );
+
+  return factors;
+}
+
+// (F(n), F(n+1)) in Montgomery form, by the fast doubling relations over the bits of n (see `fibonacci_big`).
+static std::pair<std::uint64_t, std::uint64_t> fibonacciPair( const Montgomery64& arithmetic, const std::uint64_t n )
+{
+  std::uint64_t a { arithmetic.zero() }, b { arithmetic.one() };
+  for ( int bit { 63 }; bit >= 0; --bit )
+  {
+    const std::uint64_t even { arithmetic.multiply( a, arithmetic.subtract( arithmetic.add( b, b ), a ) ) };
+    const std::uint64_t odd { arithmetic.add( arithmetic.multiply( a, a ), arithmetic.multiply( b, b ) ) };
+    a = ((n >> bit) & 1) ? odd : even;
+    b = ((n >> bit) & 1) ? arithmetic.add( even, odd ) : odd;
+  }
+  return { a, b };
+}
+
+/* Pisano period of a prime p. The period divides p - 1 when p = 1 or 9 (mod 10), and 2(p + 1) when p = 3 or 7
+ * (mod 10). Starting from that multiple, every prime factor is divided out for as long as the series still
+ * returns to (0, 1) after the smaller length.
+ */
+static std::uint64_t primePisanoPeriod( const std::uint64_t prime )
+{
+  if ( prime == 2 ) return 3;
+  if ( prime == 5 ) return 20;
+
+  const Montgomery64 arithmetic { prime };
+  const std::pair<std::uint64_t, std::uint64_t> start { arithmetic.zero(), arithmetic.one() };
+  std::uint64_t period { (prime % 10 == 1 || prime % 10 == 9) ? prime - 1 : 2 * (prime + 1) };
+  for ( const auto& [factor, exponent] : factorize( period ) )
+    for ( unsigned i { 0 }; i < exponent && fibonacciPair( arithmetic, period / factor ) == start; ++i )
+      period /= factor;
+
+  return period;
+}
+
+/* The period of a prime power p^k is p^(k-1) times the period of p (Wall's conjecture, verified for every
+ * prime that has been checked), and the period of m is the least common multiple over its prime powers.
+ * Periods never exceed 6m, so they fit in 64 bits for every m below 2^32.
+ */
+std::uint64_t pisano_period( const std::uint64_t m )
+{
+  if ( m == 0 || m >= (std::uint64_t { 1 } << 32) )
+    throw std::invalid_argument { "error: Pisano periods are only computed for moduli in [1, 2^32).\n" };
+
+  // shared by all threads, so every modulus is factored once
+  static MemoCache<std::uint64_t> periods;
+
+  return periods.getOrCompute( m, [m]
+  {
+    std::uint64_t period { 1 };
+    for ( const auto& [prime, exponent] : factorize( m ) )
+    {
+      std::uint64_t primePower { primePisanoPeriod( prime ) };
+      for ( unsigned i { 1 }; i < exponent; ++i )
+        primePower *= prime;
+      period = period / std::gcd( period, primePower ) * primePower;
+    }
+    return period;
+  } );
+}
+
+// Number of queries answered together in lock step by `answerQueries`.
+static constexpr size_t queryLanes { 4 };
+
+/* Answers `_Lanes` queries at once. For every query, m = 2^s * q with q odd : F(n) mod q is computed in Montgomery
+ * arithmetic, and F(n) mod 2^s in wrapping 64 bit arithmetic (exact, since 2^s divides 2^64), then the 2 are
+ * combined by the Chinese remainder theorem as x = b + q * ((a - b) * q^-1 mod 2^s).
+ * Every step of the loop over bits does the same work for all the lanes, with selects instead of branches, so
+ * the lanes' independent multiplications overlap. Leading zero bits leave (F(0), F(1)) unchanged, so the lanes
+ * simply run for the longest n among them.
+ */
+template<size_t _Lanes>
+static void answerQueries( const ModularQuery* const queries, std::uint64_t* const results )
+{
+  Montgomery64 odd[_Lanes];
+  std::uint64_t n[_Lanes], twoMask[_Lanes], oddA[_Lanes], oddB[_Lanes], twoA[_Lanes], twoB[_Lanes];
+  std::uint64_t allBits { 0 };
+  for ( size_t lane { 0 }; lane < _Lanes; ++lane )
+  {
+    const std::uint64_t m { queries[lane].m };
+    n[lane] = (m < (std::uint64_t { 1 } << 32)) ? queries[lane].n % pisano_period( m ) : queries[lane].n;
+    allBits |= n[lane];
+
+    unsigned twos { 0 };
+    while ( !((m >> twos) & 1) )
+      ++twos;
+    twoMask[lane] = (std::uint64_t { 1 } << twos) - 1;
+    odd[lane] = Montgomery64 { m >> twos };
+    oddA[lane] = odd[lane].zero();
+    oddB[lane] = odd[lane].one();
+    twoA[lane] = 0;
+    twoB[lane] = 1;
+  }
+
+  int topBit { 63 };
+  while ( topBit >= 0 && !((allBits >> topBit) & 1) )
+    --topBit;
+
+  for ( int bit { topBit }; bit >= 0; --bit )
+    for ( size_t lane { 0 }; lane < _Lanes; ++lane )
+    {
+      const Montgomery64& arithmetic { odd[lane] };
+      const bool set { ((n[lane] >> bit) & 1) != 0 };
+
+      const std::uint64_t a { oddA[lane] }, b { oddB[lane] };
+      const std::uint64_t even { arithmetic.multiply( a, arithmetic.subtract( arithmetic.add( b, b ), a ) ) };
+      const std::uint64_t odd { arithmetic.add( arithmetic.multiply( a, a ), arithmetic.multiply( b, b ) ) };
+      oddA[lane] = set ? odd : even;
+      oddB[lane] = set ? arithmetic.add( even, odd ) : odd;
+
+      const std::uint64_t c { twoA[lane] }, d { twoB[lane] };
+      const std::uint64_t twoEven { c * (2 * d - c) };
+      const std::uint64_t twoOdd { c * c + d * d };
+      twoA[lane] = set ? twoOdd : twoEven;
+      twoB[lane] = set ? twoEven + twoOdd : twoOdd;
+    }
+
+  for ( size_t lane { 0 }; lane < _Lanes; ++lane )
+  {
+    const std::uint64_t q { odd[lane].modulus() };
+    std::uint64_t inverse { q };                          // q^-1 mod 2^64 by Newton's iteration, as in `Montgomery64`
+    for ( int i { 0 }; i < 5; ++i )
+      inverse *= 2 - q * inverse;
+
+    const std::uint64_t modOdd { odd[lane].fromMontgomery( oddA[lane] ) };
+    const std::uint64_t modTwo { twoA[lane] & twoMask[lane] };
+    results[lane] = modOdd + q * (((modTwo - modOdd) * inverse) & twoMask[lane]);
+  }
+}
+
+// Answers the queries [first, last), 4 at a time and the rest one by one.
+static void answerRange( const ModularQuery* const queries, std::uint64_t* const results, const size_t first,
+                         const size_t last )
+{
+  TRACE_SCOPE( "fibonacci_mod_batch::range" );
+  TRACE_MOVED( (last - first) * (sizeof( ModularQuery ) + sizeof( std::uint64_t )) );
+  size_t i { first };
+  for ( ; i + queryLanes <= last; i += queryLanes )
+    answerQueries<queryLanes>( queries + i, results + i );
+  for ( ; i < last; ++i )
+    answerQueries<1>( queries + i, results + i );
+}
+
+std::uint64_t fibonacci_mod( const std::uint64_t n, const std::uint64_t m )
+{
+  const ModularQuery query { n, m };
+  std::uint64_t result;
+  fibonacci_mod_batch( &query, &result, 1 );
+  return result;
+}
+
+// Checks every modulus first, so that no worker thread ever throws, then splits the batch across threads.
+void fibonacci_mod_batch( const ModularQuery* const queries, std::uint64_t* const results, const size_t count,
+                          unsigned threads )
+{
+  TRACE_SCOPE( "fibonacci_mod_batch" );
+  for ( size_t i { 0 }; i < count; ++i )
+    if ( queries[i].m == 0 )
+      throw std::invalid_argument { "error: modulus must be positive.\n" };
+
+  if ( count < (1 << 12) )                                // answered faster than a worker thread starts
+  {
+    answerRange( queries, results, 0, count );
+    return;
+  }
+  if ( threads == 0 )
+    threads = std::max( 1U, std::thread::hardware_concurrency() );
+  threads = static_cast<unsigned>(std::min<size_t>( threads, count / queryLanes ));
+  if ( threads <= 1 )
+  {
+    answerRange( queries, results, 0, count );
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve( threads );
+  for ( unsigned t { 0U }; t < threads; ++t )
+    workers.emplace_back( answerRange, queries, results,
+                          count * t / threads / queryLanes * queryLanes,
+                          (t + 1 == threads) ? count : count * (t + 1) / threads / queryLanes * queryLanes );
+  for ( auto& worker : workers )
+    worker.join();
+}
+
+////////// Ranges of fibonacci numbers //////////
+
+// (F(n), F(n+1)) modulo 2^64, by the fast doubling relations over the bits of n
+static std::pair<std::uint64_t, std::uint64_t> wrappingPair( const std::uint64_t n )
+{
+  std::uint64_t a { 0 }, b { 1 };
+  for ( int bit { 63 }; bit >= 0; --bit )
+  {
+    const std::uint64_t even { a * (2 * b - a) }, odd { a * a + b * b };
+    a = ((n >> bit) & 1) ? odd : even;
+    b = ((n >> bit) & 1) ? even + odd : odd;
   }
+  return { a, b };
+}
 
-  return series[count];
+/* Fills `out` with `count` values from the seeds (F(first), F(first+1)) by the plain recurrence, carried in
+ * registers : one addition (and, modulo m, one conditional subtraction) per value.
+ */
+template<typename _Add>
+static void generateRange( std::uint64_t* const out, const size_t count, std::uint64_t previous, std::uint64_t current,
+                           const _Add add )
+{
+  for ( size_t i { 0 }; i < count; ++i )
+  {
+    out[i] = previous;
+    const std::uint64_t next { add( previous, current ) };
+    previous = current;
+    current = next;
+  }
+}
+
+/* Modulo 2^64 with 4 x 64 bit vectors, 8 lanes are generated at once by the jump-ahead
+ * F(k + 16) = Lucas(8) * F(k + 8) - F(k) = 47 * F(k + 8) - F(k), where every lane only depends on the 2 blocks
+ * before it. The plain recurrence already does one value per cycle, so narrower vectors (SSE2 has no 64 bit
+ * multiplication) do not pay for the extra multiplication, and neither does a modulus : a reduction per lane
+ * costs more than the conditional subtraction of the recurrence.
+ */
+#if defined(__AVX2__)
+static void generateWrappingRange( std::uint64_t* const out, const size_t count, const std::uint64_t previous,
+                                   const std::uint64_t current )
+{
+  constexpr size_t lanes { 8 };
+  const size_t head { std::min( count, 2 * lanes ) };
+  generateRange( out, head, previous, current, [] ( const std::uint64_t a, const std::uint64_t b ) { return a + b; } );
+
+  size_t i { head };
+  for ( ; i + lanes <= count; i += lanes )
+    for ( size_t lane { 0 }; lane < lanes; ++lane )
+      out[i + lane] = 47 * out[i + lane - lanes] - out[i + lane - 2 * lanes];
+  for ( ; i < count; ++i )
+    out[i] = out[i - 1] + out[i - 2];
+}
+#endif
+
+// Fills `out` with F(first) to F(first + count - 1) modulo m, or modulo 2^64 for m == 0.
+static void fillRange( const std::uint64_t first, const size_t count, std::uint64_t* const out, const std::uint64_t m )
+{
+  TRACE_SCOPE( "fibonacci_range::fill" );
+  TRACE_MOVED( count * sizeof( std::uint64_t ) );
+  if ( m == 0 )
+  {
+    const auto [previous, current] { wrappingPair( first ) };
+#if defined(__AVX2__)
+    generateWrappingRange( out, count, previous, current );
+#else
+    generateRange( out, count, previous, current, [] ( const std::uint64_t a, const std::uint64_t b ) { return a + b; } );
+#endif
+    return;
+  }
+
+  const ModularQuery queries[] { { first, m }, { first + 1, m } };
+  std::uint64_t seeds[2];
+  fibonacci_mod_batch( queries, seeds, 2, 1 );
+  generateRange( out, count, seeds[0], seeds[1],
+                 [m] ( const std::uint64_t a, const std::uint64_t b ) { return (a >= m - b) ? a - (m - b) : a + b; } );
+}
+
+void fibonacci_range( const std::uint64_t first, const std::uint64_t last, std::uint64_t* const out, const std::uint64_t m,
+                      unsigned threads )
+{
+  TRACE_SCOPE( "fibonacci_range" );
+  if ( first > last )
+    throw std::invalid_argument { "error: range must not end before it starts.\n" };
+  if ( first == last ) return;
+  if ( !out )
+    throw std::invalid_argument { "error: output buffer is null.\n" };
+
+  // every thread fills 2^16 values at least, so a range under 2^17 values need not ask how many threads there are
+  const size_t count { static_cast<size_t>(last - first) };
+  if ( threads == 0 && count >> 17 )
+    threads = std::max( 1U, std::thread::hardware_concurrency() );
+  threads = static_cast<unsigned>(std::min<size_t>( threads, count >> 16 ));
+  if ( threads <= 1 )
+  {
+    fillRange( first, count, out, m );
+    return;
+  }
+
+  // chunks of whole cache lines (8 values), so no 2 threads write the same line
+  std::vector<std::thread> workers;
+  workers.reserve( threads );
+  for ( unsigned t { 0U }; t < threads; ++t )
+  {
+    const size_t begin { count * t / threads / 8 * 8 };
+    const size_t end { (t + 1 == threads) ? count : count * (t + 1) / threads / 8 * 8 };
+    workers.emplace_back( fillRange, first + begin, end - begin, out + begin, m );
+  }
+  for ( auto& worker : workers )
+    worker.join();
 }
 
 void testFibonacci( std::function<int( size_t )> fibonacci, int count )
@@ -108,3 +636,281 @@ void testFibonacci( std::function<int( size_t )> fibonacci, int count )
     std::cout << fibonacci( i ) << '\n';
   std::cout << '\n';
 }
+
+
+// Demo of `fibonacci_big`, then its timings against repeated additions, checked with Cassini's identity.
+void testFibonacciBig()
+{
+  std::cout << fibonacci_big( 100 ) << '\n';              // 354224848179261915075
+  std::cout << fibonacci_big( 1'000 ).toString().size() << " digits in F(1000)\n";
+
+  std::cout << std::setw( 10 ) << "n" << std::setw( 12 ) << "bits" << std::setw( 16 ) << "doubling (ms)"
+    << std::setw( 16 ) << "additions (ms)" << std::setw( 10 ) << "Cassini" << '\n';
+  for ( const size_t count : { 1'000, 10'000, 100'000, 1'000'000, 10'000'000 } )
+  {
+    auto start { std::chrono::steady_clock::now() };
+    const BigInteger value { fibonacci_big( count ) };
+    const std::chrono::duration<double, std::milli> doublingTime { std::chrono::steady_clock::now() - start };
+    std::cout << std::setw( 10 ) << count << std::setw( 12 ) << value.bitLength() << std::setw( 16 ) << doublingTime.count();
+
+    // n additions of numbers growing to n bits, O(n^2)
+    if ( count <= 100'000 )
+    {
+      start = std::chrono::steady_clock::now();
+      BigInteger a { 0 }, b { 1 };
+      for ( size_t i { 0 }; i < count; ++i )
+      {
+        a += b;
+        std::swap( a, b );
+      }
+      const std::chrono::duration<double, std::milli> additionTime { std::chrono::steady_clock::now() - start };
+      std::cout << std::setw( 16 ) << additionTime.count();
+      if ( a != value )
+        std::cout << " MISMATCH";
+    }
+    else
+      std::cout << std::setw( 16 ) << '-';
+
+    // F(n-1) * F(n+1) - F(n)^2 = (-1)^n
+    if ( count <= 1'000'000 )
+    {
+      const BigInteger product { fibonacci_big( count - 1 ) * fibonacci_big( count + 1 ) };
+      const BigInteger square { value * value };
+      const bool holds { (count & 1) ? product + 1 == square : product == square + 1 };
+      std::cout << std::setw( 10 ) << (holds ? "ok" : "FAILED");
+    }
+    std::cout << '\n';
+  }
+}
+/* Demo of `fibonacci_mod`, checked against `fibonacci_mat` for small n. Then timings of `fibonacci_mod_batch`
+ * against one 2x2 matrix power per query (the `fibonacci_mat` approach, reduced modulo m with `multiplyMod`),
+ * for many queries sharing few moduli (where Pisano reduction pays off) and for random 64 bit moduli.
+ */
+void testFibonacciMod()
+{
+  std::cout << fibonacci_mod( 1'000'000'000'000'000'000ULL, 1'000'000'007ULL ) << '\n';   // 209783453
+  size_t wrong { 0 };
+  for ( std::uint64_t m { 1 }; m <= 1000; ++m )
+    for ( size_t n { 0 }; n <= 46; ++n )
+      wrong += fibonacci_mod( n, m ) != static_cast<std::uint64_t>(fibonacci_mat( n )) % m;
+  std::cout << wrong << " wrong results for n <= 46, m <= 1000\n";
+
+  // F(n) = (M ^ n)[0][1], with every product reduced modulo m
+  const auto matrixMod { [] ( const std::uint64_t n, const std::uint64_t m )
+  {
+    using Matrix2 = SmallMatrix<std::uint64_t, 2, 2>;
+    const auto addMod { [m] ( const std::uint64_t a, const std::uint64_t b ) { return (a >= m - b) ? a - (m - b) : a + b; } };
+    const Matrix2 R { power( Matrix2 { { 1, 1 }, { 1, 0 } }, n, Matrix2::identity(),
+                             [m, addMod] ( const Matrix2& a, const Matrix2& b )
+    {
+      Matrix2 product;
+      for ( size_t i { 0 }; i < 2; ++i )
+        for ( size_t j { 0 }; j < 2; ++j )
+          product[i][j] = addMod( multiplyMod( a[i][0], b[0][j], m ), multiplyMod( a[i][1], b[1][j], m ) );
+      return product;
+    } ) };
+    return R[0][1] % m;                                   // modulo 1, the identity is not reduced
+  } };
+
+  constexpr size_t count { 1 << 20 };
+  std::mt19937_64 generator { 2021 };
+  std::vector<std::uint64_t> moduli( 1000 );
+  for ( auto& m : moduli )
+    m = std::uniform_int_distribution<std::uint64_t> { 1, 999'999'999 }( generator );
+
+  std::vector<ModularQuery> fewModuli( count ), randomModuli( count );
+  for ( size_t i { 0 }; i < count; ++i )
+  {
+    fewModuli[i] = { generator(), moduli[generator() % moduli.size()] };
+    randomModuli[i] = { generator(), generator() | 1 << (generator() & 1) };   // odd and even moduli, never 0
+  }
+
+  const unsigned threads { std::max( 1U, std::thread::hardware_concurrency() ) };
+  std::cout << std::setw( 18 ) << "queries" << std::setw( 16 ) << "matrix (M/s)" << std::setw( 16 ) << "batch (M/s)"
+    << std::setw( 10 ) << "threads" << std::setw( 16 ) << "batch (M/s)" << '\n';
+  for ( const auto& [name, queries] : { std::make_pair( "1000 moduli", &fewModuli ),
+                                        std::make_pair( "random moduli", &randomModuli ) } )
+  {
+    std::vector<std::uint64_t> expected( count ), single( count ), threaded( count );
+
+    auto start { std::chrono::steady_clock::now() };
+    for ( size_t i { 0 }; i < count; ++i )
+      expected[i] = matrixMod( (*queries)[i].n, (*queries)[i].m );
+    const std::chrono::duration<double> matrixTime { std::chrono::steady_clock::now() - start };
+
+    start = std::chrono::steady_clock::now();
+    fibonacci_mod_batch( queries->data(), single.data(), count, 1 );
+    const std::chrono::duration<double> singleTime { std::chrono::steady_clock::now() - start };
+
+    start = std::chrono::steady_clock::now();
+    fibonacci_mod_batch( queries->data(), threaded.data(), count, threads );
+    const std::chrono::duration<double> threadedTime { std::chrono::steady_clock::now() - start };
+
+    std::cout << std::setw( 18 ) << name << std::setw( 16 ) << count / matrixTime.count() / 1e6
+      << std::setw( 16 ) << count / singleTime.count() / 1e6 << std::setw( 10 ) << threads
+      << std::setw( 16 ) << count / threadedTime.count() / 1e6
+      << (single == expected && threaded == expected ? "" : "  MISMATCH") << '\n';
+  }
+}
+
+/* Checks every table entry against `fibonacci_big`, and the dispatcher on both sides of its crossover. Then times
+ * the first call of each memoized function in a fresh process (the slow path, which fills its cache) against a
+ * table lookup.
+ */
+void testFibonacciTable()
+{
+  size_t wrong { 0 };
+  for ( size_t n { 0 }; n < FibonacciTable<std::uint64_t>::size; ++n )
+    wrong += BigInteger { fibonacci_table<std::uint64_t>( n ) } != fibonacci_big( n )
+      || (n < FibonacciTable<std::uint32_t>::size && fibonacci_table<std::uint32_t>( n ) != fibonacci_table<std::uint64_t>( n ));
+  for ( size_t n { 0 }; n < 400; ++n )
+    wrong += fibonacci( n ) != fibonacci_big( n );
+  std::cout << wrong << " wrong values\n";
+
+  try
+  {
+    fibonacci_table<std::uint64_t>( FibonacciTable<std::uint64_t>::size );
+    std::cout << "no exception past the end of the table\n";
+  }
+  catch ( const std::out_of_range& error )
+  {
+    std::cout << error.what();
+  }
+
+  // each function is timed once, on its first call for the largest count that fits in `int`
+  constexpr size_t count { 46 };
+  std::cout << std::setw( 10 ) << "function" << std::setw( 20 ) << "first call (ns)" << '\n';
+  for ( const auto& [name, function] : { std::make_pair( "rdp", fibonacci_rdp ), std::make_pair( "idp", fibonacci_idp ),
+                                         std::make_pair( "fd", fibonacci_fd ), std::make_pair( "mat", fibonacci_mat ) } )
+  {
+    const auto start { std::chrono::steady_clock::now() };
+    const int value { function( count ) };
+    const std::chrono::duration<double, std::nano> elapsed { std::chrono::steady_clock::now() - start };
+    std::cout << std::setw( 10 ) << name << std::setw( 20 ) << elapsed.count()
+      << (static_cast<std::uint32_t>(value) == fibonacci_table<std::uint32_t>( count ) ? "" : "  MISMATCH") << '\n';
+  }
+
+  volatile size_t index { count };                        // keeps the lookup from being folded at compile time
+  const auto start { std::chrono::steady_clock::now() };
+  const std::uint64_t value { fibonacci_table<std::uint64_t>( index ) };
+  const std::chrono::duration<double, std::nano> elapsed { std::chrono::steady_clock::now() - start };
+  std::cout << std::setw( 10 ) << "table" << std::setw( 20 ) << elapsed.count() << "  (" << value << ")\n";
+}
+
+/* Cold and warm latencies of the 4 `int` functions for counts up to 46, then the crossovers picked by
+ * `fibonacci_calibrate` (through a cache file, so a second run loads them), and the time of a sweep of all
+ * counts through `fibonacci_auto` against the same sweep through a `std::function` to each method.
+ */
+void testFibonacciLatency()
+{
+  std::cout << std::setw( 8 ) << "n";
+  for ( const char* name : methodNames )
+    std::cout << std::setw( 10 ) << name << " cold" << std::setw( 10 ) << name << " warm";
+  std::cout << "   (ns)\n" << std::fixed << std::setprecision( 1 );
+  for ( const size_t count : { 2, 5, 10, 20, 30, 40, 46 } )
+  {
+    std::cout << std::setw( 8 ) << count;
+    for ( const FibonacciMethod method : methods )
+      std::cout << std::setw( 15 ) << fibonacci_latency( method, count, true, 101 )
+        << std::setw( 15 ) << fibonacci_latency( method, count, false );
+    std::cout << '\n';
+  }
+
+  const std::string cacheFile { "fibonacci_auto.txt" };
+  auto start { std::chrono::steady_clock::now() };
+  const std::vector<FibonacciCrossover> crossovers { fibonacci_calibrate( cacheFile ) };
+  const std::chrono::duration<double, std::milli> calibrationTime { std::chrono::steady_clock::now() - start };
+  std::cout << "calibrated in " << calibrationTime.count() << " ms (" << cacheFile << ") :";
+  for ( const auto& crossover : crossovers )
+    std::cout << "  from " << crossover.first << ' ' << methodNames[static_cast<int>(crossover.method)];
+  std::cout << '\n';
+
+  constexpr size_t sweeps { 20'000 };
+  size_t wrong { 0 };
+  for ( size_t count { 0 }; count < autoCounts; ++count )
+    wrong += fibonacci_auto( count ) != fibonacci_mat( count );
+
+  volatile int sink { 0 };
+  start = std::chrono::steady_clock::now();
+  for ( size_t i { 0 }; i < sweeps; ++i )
+    for ( size_t count { 0 }; count < autoCounts; ++count )
+      sink = fibonacci_auto( count );
+  const std::chrono::duration<double, std::nano> autoTime { std::chrono::steady_clock::now() - start };
+  std::cout << std::setw( 16 ) << "auto" << std::setw( 10 ) << autoTime.count() / (sweeps * autoCounts) << " ns per call"
+    << (wrong ? "  MISMATCH" : "") << '\n';
+
+  for ( size_t m { 0 }; m < 4; ++m )
+  {
+    const std::function<int( size_t )> function { [m] ( const size_t count ) { return fibonacci_call( methods[m], count ); } };
+    start = std::chrono::steady_clock::now();
+    for ( size_t i { 0 }; i < sweeps; ++i )
+      for ( size_t count { 0 }; count < autoCounts; ++count )
+        sink = function( count );
+    const std::chrono::duration<double, std::nano> elapsed { std::chrono::steady_clock::now() - start };
+    std::cout << std::setw( 16 ) << std::string { methodNames[m] } + " function" << std::setw( 10 )
+      << elapsed.count() / (sweeps * autoCounts) << " ns per call\n";
+  }
+  static_cast<void>(sink);                                // the stores are the point, but the variable must be read
+  std::cout << std::defaultfloat;
+}
+
+/* Checks `fibonacci_range` against the table (modulo 2^64) and against `fibonacci_mod` at random offsets, then
+ * times 2^24 values per modulus : one call per index (on the first 2^16 only), a caller's loop over the array
+ * out[k + 2] = out[k + 1] + out[k] seeded the same way, and the range on 1 thread and on all threads.
+ */
+void testFibonacciRange()
+{
+  std::vector<std::uint64_t> values( FibonacciTable<std::uint64_t>::size );
+  fibonacci_range( 0, values.size(), values.data() );
+  size_t wrong { 0 };
+  for ( size_t k { 0 }; k < values.size(); ++k )
+    wrong += values[k] != fibonacci_table<std::uint64_t>( k );
+
+  std::mt19937_64 generator { 2021 };
+  for ( int trial { 0 }; trial < 200; ++trial )
+  {
+    const std::uint64_t first { generator() >> (generator() % 64) };
+    const std::uint64_t m { (trial % 4 == 3) ? generator() : generator() >> (generator() % 64) | 1 };
+    values.resize( generator() % 100 );
+    fibonacci_range( first, first + values.size(), values.data(), m );
+    for ( size_t k { 0 }; k < values.size(); ++k )
+      wrong += values[k] != fibonacci_mod( first + k, m );
+  }
+  std::cout << wrong << " wrong values\n";
+
+  constexpr size_t count { 1 << 24 }, sampled { 1 << 16 };
+  constexpr std::uint64_t first { 1'000'000'000'000ULL };
+  const unsigned threads { std::max( 1U, std::thread::hardware_concurrency() ) };
+  std::vector<std::uint64_t> expected( count ), single( count ), threaded( count );
+  std::cout << std::setw( 22 ) << "modulus" << std::setw( 16 ) << "per index" << std::setw( 16 ) << "recurrence"
+    << std::setw( 16 ) << "range" << std::setw( 10 ) << "threads" << std::setw( 16 ) << "range" << "   (M values/s)\n";
+  for ( const std::uint64_t m : { 0ULL, 1'000'000'007ULL, 0x7FFF'FFFF'FFFF'FFE7ULL, 0xFFFF'FFFF'FFFF'FFC5ULL } )
+  {
+    auto start { std::chrono::steady_clock::now() };
+    volatile std::uint64_t sink { 0 };
+    for ( size_t k { 0 }; k < sampled; ++k )
+      sink = (m == 0) ? fibonacci_range( first + k, first + k + 1, single.data() ), single[0] : fibonacci_mod( first + k, m );
+    const std::chrono::duration<double> indexTime { std::chrono::steady_clock::now() - start };
+    static_cast<void>(sink);                              // the stores are the point, but the variable must be read
+
+    start = std::chrono::steady_clock::now();
+    fibonacci_range( first, first + 2, expected.data(), m, 1 );
+    for ( size_t k { 2 }; k < count; ++k )
+      expected[k] = (m == 0) ? expected[k - 1] + expected[k - 2]
+        : (expected[k - 1] >= m - expected[k - 2]) ? expected[k - 1] - (m - expected[k - 2]) : expected[k - 1] + expected[k - 2];
+    const std::chrono::duration<double> recurrenceTime { std::chrono::steady_clock::now() - start };
+
+    start = std::chrono::steady_clock::now();
+    fibonacci_range( first, first + count, single.data(), m, 1 );
+    const std::chrono::duration<double> singleTime { std::chrono::steady_clock::now() - start };
+
+    start = std::chrono::steady_clock::now();
+    fibonacci_range( first, first + count, threaded.data(), m, threads );
+    const std::chrono::duration<double> threadedTime { std::chrono::steady_clock::now() - start };
+
+    std::cout << std::setw( 22 ) << m << std::setw( 16 ) << sampled / indexTime.count() / 1e6
+      << std::setw( 16 ) << count / recurrenceTime.count() / 1e6 << std::setw( 16 ) << count / singleTime.count() / 1e6
+      << std::setw( 10 ) << threads << std::setw( 16 ) << count / threadedTime.count() / 1e6
+      << (single == expected && threaded == expected ? "" : "  MISMATCH") << '\n';
+  }
+}
@@ -1,10 +1,21 @@
 #ifndef __fibonacci_h__
 #define __fibonacci_h__
 
+#include "bigint.h"         // BigInteger
+
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uint32_t, std::uint64_t
 #include <functional>       // std::function
+#include <stdexcept>        // std::out_of_range
+#include <string>           // std::string
+#include <vector>           // std::vector
 
 using size_t = std::size_t;
 
+/* The memoized functions (rdp, idp and fd) keep their values in a `MemoCache` (memocache.h), so they can be
+ * called from several threads at once. All the `int` functions overflow past F(46), see `fibonacci_big`.
+ */
+
 // recursive function with dynamic programming
 int fibonacci_rdp( size_t count );
 
@@ -17,7 +28,150 @@ int fibonacci_mat( size_t count );
 // recursive function using fast doubling relation of fibonacci formula
 int fibonacci_fd( size_t count );
 
+// the 4 `int` functions above, to select one by value instead of through `std::function`
+enum class FibonacciMethod
+{
+  RDP,
+  IDP,
+  MAT,
+  FD
+};
+
+// calls the function of `method`, through a switch
+int fibonacci_call( FibonacciMethod method, size_t count );
+
+// empties the caches of rdp, idp and fd. NOT thread-safe : no fibonacci function may run at the same time.
+void fibonacci_clear_caches();
+
+/* Latency of F(count) by `method`, in nanoseconds. Cold : the caches are cleared before every call, and the median
+ * of `trials` single calls is returned (clock overhead included). Warm : the cache already holds F(count), and the
+ * mean of a loop of `trials` calls is returned. Cold measurements clear the caches, so they are NOT thread-safe.
+ */
+double fibonacci_latency( FibonacciMethod method, size_t count, bool cold, size_t trials = 1000 );
+
+// from `first` on (up to the next crossover), `fibonacci_auto` calls the function of `method`
+struct FibonacciCrossover
+{
+  size_t first;
+  FibonacciMethod method;
+};
+
+/* Picks the fastest method for every count up to 46 (the largest F(count) that fits in `int`) by their warm
+ * latencies, once per process : the first call either loads the crossovers from `cacheFile`, or measures them and
+ * saves them there (a file that can not be written is skipped). An empty name only measures.
+ * Later calls, with any file, return the crossovers already in use.
+ */
+std::vector<FibonacciCrossover> fibonacci_calibrate( const std::string& cacheFile = "" );
+
+// F(count) by the fastest method for `count`, calibrating first if `fibonacci_calibrate` has not been called yet
+int fibonacci_auto( size_t count );
+
+/* exact value of any size, using the fast doubling formula over the bits of `count` :
+ * O(log(count)) big multiplications, keeping only the current pair of values instead of a memo of every index
+ */
+BigInteger fibonacci_big( size_t count );
+
+/* Every fibonacci number that fits in the unsigned integer `_Integer`, generated at compile time :
+ * F(0) to F(47) for 32 bits, F(93) for 64 bits and F(186) for 128 bits. Nothing is filled at run time, so
+ * the first lookup is as fast as any other.
+ */
+template<typename _Integer>
+struct FibonacciTable
+{
+  static_assert( static_cast<_Integer>(-1) > 0, "FibonacciTable requires an unsigned integer type" );
+
+  // counts the values up to the first sum that would wrap around
+  static constexpr size_t size { []
+  {
+    _Integer a { 0 }, b { 1 };
+    size_t count { 2 };
+    for ( ; a <= static_cast<_Integer>(-1) - b; ++count )
+    {
+      const _Integer next { a + b };
+      a = b;
+      b = next;
+    }
+    return count;
+  }() };
+
+  _Integer values[size];
+
+  constexpr FibonacciTable() : values { }
+  {
+    values[1] = 1;
+    for ( size_t i { 2 }; i < size; ++i )
+      values[i] = values[i - 1] + values[i - 2];
+  }
+};
+
+template<typename _Integer>
+inline constexpr FibonacciTable<_Integer> fibonacciTable { };
+
+// O(1) lookup in the compile time table, throws `std::out_of_range` if F(count) does not fit in `_Integer`
+template<typename _Integer>
+constexpr _Integer fibonacci_table( const size_t count )
+{
+  if ( count >= FibonacciTable<_Integer>::size )
+    throw std::out_of_range { "error: fibonacci number does not fit in the table's type.\n" };
+  return fibonacciTable<_Integer>.values[count];
+}
+
+/* exact value of any size : a table lookup while F(count) fits in the widest table (128 bits where the compiler
+ * has `unsigned __int128`, 64 bits otherwise), `fibonacci_big` beyond it
+ */
+BigInteger fibonacci( size_t count );
+
+// one query of the modular batch API, F(n) mod m
+struct ModularQuery
+{
+  std::uint64_t n;
+  std::uint64_t m;
+};
+
+/* Pisano period of `m`, the period of the fibonacci series modulo m, so that F(n) mod m = F(n mod period) mod m.
+ * Computed from the prime factorization of m (by trial division, so m must be in [1, 2^32)), and cached :
+ * every modulus is only ever factored once, by any thread.
+ */
+std::uint64_t pisano_period( std::uint64_t m );
+
+// F(n) mod m for any n and any m > 0, see `fibonacci_mod_batch`
+std::uint64_t fibonacci_mod( std::uint64_t n, std::uint64_t m );
+
+/* F(n) mod m for every query, into `results[i]` for `queries[i]`. Every n is first reduced by the (cached)
+ * Pisano period of its m, when m < 2^32. The rest is fast doubling in 64 bit Montgomery arithmetic for the odd
+ * part of m, and in plain wrapping arithmetic for its power of 2 part, combined by the Chinese remainder theorem.
+ * Queries are answered 4 at a time in lock step, so the long multiplication chains of independent queries
+ * overlap in the CPU pipeline. Large batches are split into contiguous ranges across `threads` threads
+ * (0 = hardware concurrency). Throws `std::invalid_argument` if any m is 0, before answering anything.
+ */
+void fibonacci_mod_batch( const ModularQuery* queries, std::uint64_t* results, size_t count, unsigned threads = 0 );
+
+/* F(k) for every k in [first, last), into `out[k - first]`, modulo `m` (any m > 0), or modulo 2^64 for m == 0
+ * (exact up to F(93), see `FibonacciTable`). The 2 seeds at `first` come from fast doubling, then the values
+ * follow from the recurrence, carried in registers; modulo 2^64 with AVX2, 8 lanes at a time by a jump-ahead.
+ * Ranges of at least 2^17 values are split into contiguous chunks across `threads` threads
+ * (0 = hardware concurrency), each seeded on its own.
+ * Throws `std::invalid_argument` if `first` > `last`, or if `out` is null for a non-empty range.
+ */
+void fibonacci_range( std::uint64_t first, std::uint64_t last, std::uint64_t* out, std::uint64_t m = 0,
+                      unsigned threads = 0 );
+
 // simple test function
 void testFibonacci( std::function<int( size_t )> fibonacci, int count );
 
+// benchmark of `fibonacci_big` for counts from 1e3 to 1e7
+void testFibonacciBig();
+
+// cold and warm latencies of the 4 methods across counts, then calibration and timings of `fibonacci_auto`
+void testFibonacciLatency();
+
+// checks of the lookup tables against `fibonacci_big`, and timings of first calls against the memoized functions
+void testFibonacciTable();
+
+// checks and benchmark of `fibonacci_range` against per-index calls and the plain recurrence
+void testFibonacciRange();
+
+// benchmark of `fibonacci_mod_batch` against per-query matrix exponentiation
+void testFibonacciMod();
+
 #endif
\ No newline at end of file
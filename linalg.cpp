@@ -0,0 +1,310 @@
+// Implementations of algorithms described in `linalg.h`
+
+#include "linalg.h"
+
+#include <algorithm>        // std::max, std::min, std::swap_ranges
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
+#include <cmath>            // std::abs
+#include <iomanip>          // std::setw
+#include <iostream>         // std::cout, std::cerr
+#include <random>           // std::mt19937, std::uniform_real_distribution
+#include <stdexcept>        // std::invalid_argument, std::runtime_error
+#include <type_traits>      // std::is_floating_point_v
+
+////////// Kernels on raw row-major blocks //////////
+
+// Diagonal blocks of the triangular solves are solved row by row, everything off the diagonal goes through
+// `multiplyAccumulate`. Panels narrower than this are factored column by column.
+static constexpr size_t triangularBlock { 64 };
+static constexpr size_t unblockedWidth { 16 };
+
+/* Solves L * X = B in place for the lower triangular (n x n) block `l` and the (n x cols) block `b`.
+ * Each diagonal block is solved by row operations, then its solution is subtracted from all the rows below
+ * with a single product. Time complexity ~ O(n^2 * cols).
+ */
+template<typename _NumericType>
+static void lowerSolve( const _NumericType* const l, const size_t ldl, _NumericType* const b, const size_t ldb,
+                        const size_t n, const size_t cols, const bool unitDiagonal )
+{
+  for ( size_t k0 { 0ULL }; k0 < n; k0 += triangularBlock )
+  {
+    const size_t k1 { std::min( k0 + triangularBlock, n ) };
+    for ( size_t i { k0 }; i < k1; ++i )
+    {
+      _NumericType* const row { b + i * ldb };
+      for ( size_t r { k0 }; r < i; ++r )
+      {
+        const _NumericType scale { l[i * ldl + r] };
+        const _NumericType* const solved { b + r * ldb };
+        for ( size_t col { 0ULL }; col < cols; ++col )
+          row[col] -= scale * solved[col];
+      }
+      if ( !unitDiagonal )
+        for ( size_t col { 0ULL }; col < cols; ++col )
+          row[col] /= l[i * ldl + i];
+    }
+
+    multiplyAccumulate( l + k1 * ldl + k0, ldl, b + k0 * ldb, ldb, b + k1 * ldb, ldb,
+                        n - k1, k1 - k0, cols, _NumericType { -1 } );
+  }
+}
+
+/* Solves U * X = B in place for the upper triangular (n x n) block `u` and the (n x cols) block `b`.
+ * Same as `lowerSolve`, walking the diagonal blocks from the bottom up. Time complexity ~ O(n^2 * cols).
+ */
+template<typename _NumericType>
+static void upperSolve( const _NumericType* const u, const size_t ldu, _NumericType* const b, const size_t ldb,
+                        const size_t n, const size_t cols )
+{
+  for ( size_t k1 { n }; k1 > 0; )
+  {
+    const size_t k0 { k1 > triangularBlock ? k1 - triangularBlock : 0 };
+    for ( size_t i { k1 }; i-- > k0; )
+    {
+      _NumericType* const row { b + i * ldb };
+      for ( size_t r { i + 1 }; r < k1; ++r )
+      {
+        const _NumericType scale { u[i * ldu + r] };
+        const _NumericType* const solved { b + r * ldb };
+        for ( size_t col { 0ULL }; col < cols; ++col )
+          row[col] -= scale * solved[col];
+      }
+      for ( size_t col { 0ULL }; col < cols; ++col )
+        row[col] /= u[i * ldu + i];
+    }
+
+    multiplyAccumulate( u + k0, ldu, b + k0 * ldb, ldb, b, ldb, k0, k1 - k0, cols, _NumericType { -1 } );
+    k1 = k0;
+  }
+}
+
+/* Factors the columns [c0, c1) of the (n x n) array `a`, over rows [c0, n), assuming every column before c0 is
+ * already factored and applied. Pivot rows are swapped along their whole length, so the swaps reach the factored
+ * columns to the left and the unfactored ones to the right at once.
+ * Wide panels are split in halves recursively : the left half is factored, the top of the right half is solved
+ * with the left half's L, the rest of the right half is updated with one product, and the right half is factored.
+ * Doing the panel the same way as the whole matrix keeps the panel's work in `multiplyAccumulate` as well,
+ * instead of one pass over all the rows below for every column of the panel.
+ */
+template<typename _NumericType>
+static void factorPanel( _NumericType* const a, const size_t n, const size_t c0, const size_t c1, size_t* const pivots )
+{
+  if ( c1 - c0 <= unblockedWidth )
+  {
+    for ( size_t j { c0 }; j < c1; ++j )
+    {
+      size_t pivot { j };
+      for ( size_t i { j + 1 }; i < n; ++i )
+        if ( std::abs( a[i * n + j] ) > std::abs( a[pivot * n + j] ) )
+          pivot = i;
+      if ( a[pivot * n + j] == _NumericType { 0 } )
+        throw std::runtime_error { "error: matrix is singular.\n" };
+
+      pivots[j] = pivot;
+      if ( pivot != j )
+        std::swap_ranges( a + j * n, a + (j + 1) * n, a + pivot * n );
+
+      const _NumericType* const pivotRow { a + j * n };
+      for ( size_t i { j + 1 }; i < n; ++i )
+      {
+        _NumericType* const row { a + i * n };
+        const _NumericType scale { row[j] /= pivotRow[j] };
+        for ( size_t col { j + 1 }; col < c1; ++col )
+          row[col] -= scale * pivotRow[col];
+      }
+    }
+    return;
+  }
+
+  const size_t mid { c0 + (c1 - c0) / 2 };
+  factorPanel( a, n, c0, mid, pivots );
+  lowerSolve( a + c0 * n + c0, n, a + c0 * n + mid, n, mid - c0, c1 - mid, true );
+  multiplyAccumulate( a + mid * n + c0, n, a + c0 * n + mid, n, a + mid * n + mid, n,
+                      n - mid, mid - c0, c1 - mid, _NumericType { -1 } );
+  factorPanel( a, n, mid, c1, pivots );
+}
+
+////////// LU decomposition and solvers //////////
+
+/* For every block of columns [k0, k1) : factor the panel, solve the block row of U to its right, U12 = L11^-1 * A12,
+ * then update the trailing submatrix, A22 -= L21 * U12. The update is a (n - k1) x blockSize x (n - k1) product,
+ * so for n much larger than the block size nearly all the operations run in `multiplyAccumulate`.
+ */
+template<typename _NumericType>
+std::vector<size_t> lu_decompose( Matrix<_NumericType>& A, const size_t blockSize )
+{
+  static_assert( std::is_floating_point_v<_NumericType>, "LU decomposition requires a floating point type" );
+  if ( A.rows() != A.cols() )
+    throw std::invalid_argument { "error: only square matrices can be decomposed.\n" };
+  if ( blockSize == 0 )
+    throw std::invalid_argument { "error: block size must be positive.\n" };
+
+  const size_t n { A.rows() };
+  _NumericType* const a { A.begin() };
+  std::vector<size_t> pivots( n );
+
+  for ( size_t k0 { 0ULL }; k0 < n; k0 += blockSize )
+  {
+    const size_t k1 { std::min( k0 + blockSize, n ) };
+    factorPanel( a, n, k0, k1, pivots.data() );
+    lowerSolve( a + k0 * n + k0, n, a + k0 * n + k1, n, k1 - k0, n - k1, true );
+    multiplyAccumulate( a + k1 * n + k0, n, a + k0 * n + k1, n, a + k1 * n + k1, n,
+                        n - k1, k1 - k0, n - k1, _NumericType { -1 } );
+  }
+
+  return pivots;
+}
+
+// Checks that the right-hand sides fit a square triangular matrix, then solves with `lowerSolve`.
+template<typename _NumericType>
+void solve_lower( const Matrix<_NumericType>& L, Matrix<_NumericType>& B, const bool unitDiagonal )
+{
+  static_assert( std::is_floating_point_v<_NumericType>, "triangular solves require a floating point type" );
+  if ( L.rows() != L.cols() || L.rows() != B.rows() )
+    throw std::invalid_argument { "error: dimensions of the triangular matrix and the right-hand sides do not match.\n" };
+
+  lowerSolve( L.begin(), L.cols(), B.begin(), B.cols(), L.rows(), B.cols(), unitDiagonal );
+}
+
+// Checks that the right-hand sides fit a square triangular matrix, then solves with `upperSolve`.
+template<typename _NumericType>
+void solve_upper( const Matrix<_NumericType>& U, Matrix<_NumericType>& B )
+{
+  static_assert( std::is_floating_point_v<_NumericType>, "triangular solves require a floating point type" );
+  if ( U.rows() != U.cols() || U.rows() != B.rows() )
+    throw std::invalid_argument { "error: dimensions of the triangular matrix and the right-hand sides do not match.\n" };
+
+  upperSolve( U.begin(), U.cols(), B.begin(), B.cols(), U.rows(), B.cols() );
+}
+
+// Replays the row swaps on B, P * A * X = P * B, then solves L * Y = P * B and U * X = Y.
+template<typename _NumericType>
+void lu_solve( const Matrix<_NumericType>& LU, const std::vector<size_t>& pivots, Matrix<_NumericType>& B )
+{
+  if ( pivots.size() != LU.rows() )
+    throw std::invalid_argument { "error: pivots do not belong to the decomposed matrix.\n" };
+  if ( LU.rows() != B.rows() )
+    throw std::invalid_argument { "error: dimensions of the triangular matrix and the right-hand sides do not match.\n" };
+
+  const size_t cols { B.cols() };
+  _NumericType* const b { B.begin() };
+  for ( size_t i { 0ULL }; i < pivots.size(); ++i )
+    if ( pivots[i] != i )
+      std::swap_ranges( b + i * cols, b + (i + 1) * cols, b + pivots[i] * cols );
+
+  solve_lower( LU, B, true );
+  solve_upper( LU, B );
+}
+
+template<typename _NumericType>
+Matrix<_NumericType> solve( const Matrix<_NumericType>& A, const Matrix<_NumericType>& B )
+{
+  if ( A.rows() != B.rows() )
+    throw std::invalid_argument { "error: dimensions of the matrix and the right-hand sides do not match.\n" };
+
+  Matrix<_NumericType> LU { A };
+  const std::vector<size_t> pivots { lu_decompose( LU ) };
+  Matrix<_NumericType> X { B };
+  lu_solve( LU, pivots, X );
+
+  return X;
+}
+
+// Template instantiations for the floating point types of `Matrix`
+template std::vector<size_t> lu_decompose( Matrix<float>&, const size_t );
+template std::vector<size_t> lu_decompose( Matrix<double>&, const size_t );
+template std::vector<size_t> lu_decompose( Matrix<long double>&, const size_t );
+template void solve_lower( const Matrix<float>&, Matrix<float>&, const bool );
+template void solve_lower( const Matrix<double>&, Matrix<double>&, const bool );
+template void solve_lower( const Matrix<long double>&, Matrix<long double>&, const bool );
+template void solve_upper( const Matrix<float>&, Matrix<float>& );
+template void solve_upper( const Matrix<double>&, Matrix<double>& );
+template void solve_upper( const Matrix<long double>&, Matrix<long double>& );
+template void lu_solve( const Matrix<float>&, const std::vector<size_t>&, Matrix<float>& );
+template void lu_solve( const Matrix<double>&, const std::vector<size_t>&, Matrix<double>& );
+template void lu_solve( const Matrix<long double>&, const std::vector<size_t>&, Matrix<long double>& );
+template Matrix<float> solve( const Matrix<float>&, const Matrix<float>& );
+template Matrix<double> solve( const Matrix<double>&, const Matrix<double>& );
+template Matrix<long double> solve( const Matrix<long double>&, const Matrix<long double>& );
+
+// Largest absolute row sum, the infinity norm.
+template<typename _NumericType>
+static double normInf( const Matrix<_NumericType>& mat )
+{
+  double norm { 0.0 };
+  const _NumericType* value { mat.begin() };
+  for ( size_t row { 0ULL }; row < mat.rows(); ++row )
+  {
+    double sum { 0.0 };
+    for ( size_t col { 0ULL }; col < mat.cols(); ++col )
+      sum += std::abs( static_cast<double>(*value++) );
+    norm = std::max( norm, sum );
+  }
+  return norm;
+}
+
+/* Factors a random (n x n) matrix and solves for `rhs` random right-hand sides. Prints the time and rate of the
+ * factorization, counted as (2/3)n^3 operations, the time of the solve, and the normwise relative residual
+ * ||A*X - B|| / (||A|| * ||X|| + ||B||), which stays a small multiple of the machine epsilon for a stable solve.
+ */
+template<typename _NumericType>
+static void benchmarkSolve( const char* const name, const size_t n, const size_t rhs )
+{
+  std::mt19937 generator { 2021 };
+  std::uniform_real_distribution<double> element { -1.0, 1.0 };
+  Matrix<_NumericType> A { n, n }, B { n, rhs };
+  for ( auto& el : A ) el = static_cast<_NumericType>(element( generator ));
+  for ( auto& el : B ) el = static_cast<_NumericType>(element( generator ));
+
+  Matrix<_NumericType> LU { A };
+  auto start { std::chrono::steady_clock::now() };
+  const std::vector<size_t> pivots { lu_decompose( LU ) };
+  const std::chrono::duration<double> factorTime { std::chrono::steady_clock::now() - start };
+
+  Matrix<_NumericType> X { B };
+  start = std::chrono::steady_clock::now();
+  lu_solve( LU, pivots, X );
+  const std::chrono::duration<double> solveTime { std::chrono::steady_clock::now() - start };
+
+  const double residual { normInf( A * X - B ) / (normInf( A ) * normInf( X ) + normInf( B )) };
+  const double operations { 2.0 / 3.0 * n * n * n };
+  std::cout << std::setw( 12 ) << name << std::setw( 6 ) << n << std::setw( 14 ) << factorTime.count() * 1e3
+    << std::setw( 10 ) << operations / factorTime.count() / 1e9 << std::setw( 12 ) << solveTime.count() * 1e3
+    << std::setw( 14 ) << residual << '\n';
+}
+
+// Simple test function for the solver demo, followed by the benchmark.
+void testLinearSolver()
+{
+  const Matrix<double> A { 3, 3, {
+    { 2, 1, 1 },
+    { 4, -6, 0 },
+    { -2, 7, 2 }
+  } };
+  const Matrix<double> B { 3, 2, {
+    { 5, 1 },
+    { -2, 0 },
+    { 9, 0 }
+  } };
+  const Matrix<double> X { solve( A, B ) };
+  X.view();                                               // first column is (1, 1, 2)
+  (A * X - B).view();                                     // zero, up to rounding
+
+  try
+  {
+    solve( Matrix<double> { 2, 2, { { 1, 2 }, { 2, 4 } } }, Matrix<double> { 2, 1 } );
+  }
+  catch ( std::runtime_error& exception )
+  {
+    std::cerr << exception.what();
+  }
+
+  std::cout << std::setw( 12 ) << "type" << std::setw( 6 ) << "n" << std::setw( 14 ) << "factor (ms)"
+    << std::setw( 10 ) << "GFLOP/s" << std::setw( 12 ) << "solve (ms)" << std::setw( 14 ) << "residual" << '\n';
+  for ( const size_t n : { 256, 512, 1024, 2048 } )
+    benchmarkSolve<float>( "float", n, 16 );
+  for ( const size_t n : { 256, 512, 1024, 2048, 4096, 8192 } )
+    benchmarkSolve<double>( "double", n, 16 );
+  for ( const size_t n : { 256, 512 } )
+    benchmarkSolve<long double>( "long double", n, 16 );
+}
\ No newline at end of file
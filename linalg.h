@@ -0,0 +1,59 @@
+#ifndef __linalg_h__
+#define __linalg_h__
+
+#include "structs.h"        // Matrix
+
+#include <cstddef>          // std::size_t
+#include <vector>           // std::vector
+
+using size_t = std::size_t;
+
+/*//////////////////////////////////////// Dense linear algebra on `Matrix` ////////////////////////////////////////
+ *
+ * Only defined for the floating point instances of `Matrix` (float, double, long double).
+ * Matrices are factored in place, and right-hand sides are solved in place, so a solve allocates nothing beyond
+ * the pivot indices. All the O(n^3) work of the factorization and of the triangular solves is done by
+ * `multiplyAccumulate` (structs.h), the same kernel behind `Matrix` multiplication.
+ */
+
+/* In-place LU decomposition with partial pivoting, P * A = L * U, of a square matrix.
+ * Afterwards, the strict lower triangle of `A` holds L (whose diagonal of ones is implied) and the upper triangle
+ * holds U. `pivots[i]` is the row that was swapped with row i at step i, the swaps have to be replayed in order.
+ * Blocked, right-looking : every block of `blockSize` columns is factored on its own (the panel), the block rows
+ * of U to its right are solved, and the rest of the matrix (the trailing submatrix) is updated with one
+ * matrix product, which is where nearly all the work is done.
+ * Throws `std::invalid_argument` for a non-square matrix, and `std::runtime_error` for a singular one.
+ * Time complexity ~ O(n^3), (2/3)n^3 floating point operations.
+ */
+template<typename _NumericType>
+std::vector<size_t> lu_decompose( Matrix<_NumericType>& A, const size_t blockSize = 128 );
+
+/* Solves L * X = B in place (B becomes X) for a lower triangular L, with a diagonal of ones when `unitDiagonal`
+ * (as stored by `lu_decompose`). Only the lower triangle of `L` is read. Time complexity ~ O(n^2 * B.cols()).
+ */
+template<typename _NumericType>
+void solve_lower( const Matrix<_NumericType>& L, Matrix<_NumericType>& B, const bool unitDiagonal = false );
+
+/* Solves U * X = B in place (B becomes X) for an upper triangular U. Only the upper triangle of `U` is read.
+ * Time complexity ~ O(n^2 * B.cols()).
+ */
+template<typename _NumericType>
+void solve_upper( const Matrix<_NumericType>& U, Matrix<_NumericType>& B );
+
+/* Solves A * X = B in place (B becomes X), given the output of `lu_decompose` for A.
+ * Every column of B is a separate right-hand side, and all of them are solved together.
+ * Time complexity ~ O(n^2 * B.cols()).
+ */
+template<typename _NumericType>
+void lu_solve( const Matrix<_NumericType>& LU, const std::vector<size_t>& pivots, Matrix<_NumericType>& B );
+
+/* Returns X such that A * X = B, for a square A and any number of right-hand sides (columns of B).
+ * Factors a copy of A, so for repeated solves with the same A use `lu_decompose` and `lu_solve` instead.
+ * Time complexity ~ O(n^3 + n^2 * B.cols()).
+ */
+template<typename _NumericType>
+Matrix<_NumericType> solve( const Matrix<_NumericType>& A, const Matrix<_NumericType>& B );
+
+void testLinearSolver();                                  // demo and benchmark (GFLOP/s and residuals)
+
+#endif
\ No newline at end of file
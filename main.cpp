@@ -1,7 +1,17 @@
+#include "algos.h"
 #include "customcast.h"
 #include "fibonacci.h"
+#include "linalg.h"
+#include "matrixbatch.h"
+#include "matrixio.h"
+#include "memocache.h"
+#include "parallel.h"
+#include "pool.h"
+#include "smallmatrix.h"
 #include "sort.h"
+#include "sparse.h"
 #include "structs.h"
+#include "trace.h"
 
 #include <cstdlib>          // EXIT_SUCCESS
 #include <functional>       // function
@@ -21,8 +31,27 @@ int main()
   // std::cout << x;
 
   //testArray2d();
+  //testTranspose();
+  //testParallelMatrix();
   //testCustomCast();
+  //testBatchCast();
   //testFibonacci( fibonacci_mat, 11 );
+  //testFibonacciBig();
+  //testFibonacciLatency();
+  //testFibonacciTable();
+  //testFibonacciMod();
+  //testFibonacciRange();
+  //testSparseMatrix();
+  //testMatrixIO();
+  //testSmallMatrix();
+  //testPower();
+  //testMatrixBatch();
+  //testLinearSolver();
+  //testMemoCache();
+  //testParallelFor();
+  //testTrace();
+  //testParallelSort();
+  //testPool();
   testSort();
   return EXIT_SUCCESS;
 }
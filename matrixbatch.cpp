@@ -0,0 +1,419 @@
+// Implementations of data structures described in `matrixbatch.h`
+
+#include "matrixbatch.h"
+
+#include <algorithm>        // std::copy, std::fill, std::max, std::min
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
+#include <cmath>            // std::abs
+#include <iomanip>          // std::setw
+#include <iostream>         // std::cout
+#include <random>           // std::mt19937, std::uniform_real_distribution
+#include <stdexcept>        // std::invalid_argument, std::out_of_range
+#include <thread>           // std::thread
+#include <utility>          // std::index_sequence, std::make_index_sequence
+#include <vector>           // std::vector
+
+////////// Batched multiplication kernels //////////
+
+/* Every kernel multiplies the matrices [first, last) of (m x k) * (k x n) products. For the interleaved kernels,
+ * `first` and `last` count groups of `MatrixBatch::groupSize` matrices instead of single matrices.
+ */
+template<typename _NumericType>
+using BatchKernel = void (*)( const _NumericType* a, const _NumericType* b, _NumericType* c,
+                              size_t m, size_t k, size_t n, size_t first, size_t last );
+
+/* Contiguous layout, any shape. Each product loops row, inner, column, so the innermost loop runs along a row of B
+ * and of C, and vectorizes.
+ * Time complexity ~ O((last - first) * m * k * n).
+ */
+template<typename _NumericType>
+static void contiguousGeneric( const _NumericType* const a, const _NumericType* const b, _NumericType* const c,
+                               const size_t m, const size_t k, const size_t n, const size_t first, const size_t last )
+{
+  for ( size_t matrix { first }; matrix < last; ++matrix )
+  {
+    const _NumericType* const lhs { a + matrix * m * k };
+    const _NumericType* const rhs { b + matrix * k * n };
+    _NumericType* const out { c + matrix * m * n };
+    for ( size_t row { 0ULL }; row < m; ++row )
+    {
+      _NumericType* const outRow { out + row * n };
+      std::fill( outRow, outRow + n, _NumericType { } );
+      for ( size_t p { 0ULL }; p < k; ++p )
+      {
+        const _NumericType scale { lhs[row * k + p] };
+        for ( size_t col { 0ULL }; col < n; ++col )
+          outRow[col] += scale * rhs[p * n + col];
+      }
+    }
+  }
+}
+
+/* Contiguous layout, (_Size x _Size) matrices. With the size known at compile time, every loop has a constant
+ * trip count, so the compiler unrolls them fully and keeps a whole output row in registers.
+ */
+template<typename _NumericType, size_t _Size>
+static void contiguousSquare( const _NumericType* const a, const _NumericType* const b, _NumericType* const c,
+                              const size_t, const size_t, const size_t, const size_t first, const size_t last )
+{
+  constexpr size_t elements { _Size * _Size };
+  for ( size_t matrix { first }; matrix < last; ++matrix )
+  {
+    const _NumericType* const lhs { a + matrix * elements };
+    const _NumericType* const rhs { b + matrix * elements };
+    _NumericType* const out { c + matrix * elements };
+    for ( size_t row { 0ULL }; row < _Size; ++row )
+    {
+      _NumericType outRow[_Size] { };
+      for ( size_t p { 0ULL }; p < _Size; ++p )
+      {
+        const _NumericType scale { lhs[row * _Size + p] };
+        for ( size_t col { 0ULL }; col < _Size; ++col )
+          outRow[col] += scale * rhs[p * _Size + col];
+      }
+      std::copy( outRow, outRow + _Size, out + row * _Size );
+    }
+  }
+}
+
+/* Interleaved layout, any shape. The matrices of a group are multiplied side by side, looping row, inner, column
+ * as `contiguousGeneric` does, with the innermost loop running over the matrices of the group: it reads
+ * adjacent elements, so every SIMD lane computes the same element of a different matrix, with no shuffles.
+ */
+template<typename _NumericType>
+static void interleavedGeneric( const _NumericType* const a, const _NumericType* const b, _NumericType* const c,
+                                const size_t m, const size_t k, const size_t n, const size_t first, const size_t last )
+{
+  constexpr size_t lanes { MatrixBatch<_NumericType>::groupSize };
+  for ( size_t group { first }; group < last; ++group )
+  {
+    const _NumericType* const lhs { a + group * m * k * lanes };
+    const _NumericType* const rhs { b + group * k * n * lanes };
+    _NumericType* const out { c + group * m * n * lanes };
+    for ( size_t row { 0ULL }; row < m; ++row )
+    {
+      _NumericType* const outRow { out + row * n * lanes };
+      std::fill( outRow, outRow + n * lanes, _NumericType { } );
+      for ( size_t p { 0ULL }; p < k; ++p )
+      {
+        const _NumericType* const x { lhs + (row * k + p) * lanes };
+        for ( size_t col { 0ULL }; col < n; ++col )
+        {
+          const _NumericType* const y { rhs + (p * n + col) * lanes };
+          _NumericType* const z { outRow + col * lanes };
+          for ( size_t lane { 0ULL }; lane < lanes; ++lane )
+            z[lane] += x[lane] * y[lane];
+        }
+      }
+    }
+  }
+}
+
+/* Interleaved layout, (_Size x _Size) matrices. The output row of the whole group is accumulated in a local
+ * array with constant bounds, so the compiler fully unrolls and vectorizes its updates. With `_Size * groupSize`
+ * elements (up to 256) it does not fit in the SIMD registers, and lives on the stack, in L1 cache.
+ */
+template<typename _NumericType, size_t _Size>
+static void interleavedSquare( const _NumericType* const a, const _NumericType* const b, _NumericType* const c,
+                               const size_t, const size_t, const size_t, const size_t first, const size_t last )
+{
+  constexpr size_t lanes { MatrixBatch<_NumericType>::groupSize };
+  constexpr size_t elements { _Size * _Size * lanes };
+  for ( size_t group { first }; group < last; ++group )
+  {
+    const _NumericType* const lhs { a + group * elements };
+    const _NumericType* const rhs { b + group * elements };
+    _NumericType* const out { c + group * elements };
+    for ( size_t row { 0ULL }; row < _Size; ++row )
+    {
+      _NumericType accumulator[_Size][lanes] { };
+      for ( size_t p { 0ULL }; p < _Size; ++p )
+      {
+        const _NumericType* const x { lhs + (row * _Size + p) * lanes };
+        for ( size_t col { 0ULL }; col < _Size; ++col )
+        {
+          const _NumericType* const y { rhs + (p * _Size + col) * lanes };
+          for ( size_t lane { 0ULL }; lane < lanes; ++lane )
+            accumulator[col][lane] += x[lane] * y[lane];
+        }
+      }
+      std::copy( &accumulator[0][0], &accumulator[0][0] + _Size * lanes, out + row * _Size * lanes );
+    }
+  }
+}
+
+// Smallest and largest square size with a specialized kernel.
+static constexpr size_t minSpecializedSize { 2 };
+static constexpr size_t maxSpecializedSize { 16 };
+
+/* Picks the kernel for a layout and shape. The specialized kernels are collected into tables indexed by size,
+ * generated from an index sequence so that every size from `minSpecializedSize` to `maxSpecializedSize` is covered.
+ */
+template<typename _NumericType, size_t... _Offset>
+static BatchKernel<_NumericType> selectKernel( const BatchLayout layout, const size_t m, const size_t k, const size_t n,
+                                               std::index_sequence<_Offset...> )
+{
+  static constexpr BatchKernel<_NumericType> contiguous[] {
+    &contiguousSquare<_NumericType, minSpecializedSize + _Offset>...
+  };
+  static constexpr BatchKernel<_NumericType> interleaved[] {
+    &interleavedSquare<_NumericType, minSpecializedSize + _Offset>...
+  };
+
+  if ( m == k && k == n && m >= minSpecializedSize && m <= maxSpecializedSize )
+    return (layout == BatchLayout::Contiguous ? contiguous : interleaved)[m - minSpecializedSize];
+
+  return layout == BatchLayout::Contiguous ? &contiguousGeneric<_NumericType> : &interleavedGeneric<_NumericType>;
+}
+
+//////////////////////////////////////////// MatrixBatch ////////////////////////////////////////////
+
+// Basic constructor, the elements are zero-initialized.
+template<typename _NumericType>
+MatrixBatch<_NumericType>::MatrixBatch( const size_t count, const size_t rows, const size_t cols, const BatchLayout layout ) :
+  __count { count },
+  __rows { rows },
+  __cols { cols },
+  __layout { layout },
+  __data { (count && rows && cols) ? std::make_unique<_NumericType[]>( __stored() * rows * cols ) : nullptr }
+{
+  if ( !__data ) throw std::invalid_argument { "error: batch has either 0 matrices, 0 rows or 0 columns.\n" };
+}
+
+// Deep copy of the whole buffer. Time complexity ~ O(count*rows*cols).
+template<typename _NumericType>
+MatrixBatch<_NumericType>::MatrixBatch( const MatrixBatch& copy ) :
+  MatrixBatch { copy.__count, copy.__rows, copy.__cols, copy.__layout }
+{
+  std::copy( copy.begin(), copy.end(), begin() );
+}
+
+template<typename _NumericType>
+inline
+size_t MatrixBatch<_NumericType>::__index( const size_t matrix, const size_t row, const size_t col ) const
+{
+  return __layout == BatchLayout::Contiguous
+    ? (matrix * __rows + row) * __cols + col
+    : ((matrix / groupSize * __rows + row) * __cols + col) * groupSize + matrix % groupSize;
+}
+
+// The interleaved layout rounds the count up to whole groups.
+template<typename _NumericType>
+inline
+size_t MatrixBatch<_NumericType>::__stored() const
+{
+  return __layout == BatchLayout::Contiguous ? __count : (__count + groupSize - 1) / groupSize * groupSize;
+}
+
+template<typename _NumericType>
+inline
+size_t MatrixBatch<_NumericType>::count() const { return __count; }
+
+template<typename _NumericType>
+inline
+size_t MatrixBatch<_NumericType>::rows() const { return __rows; }
+
+template<typename _NumericType>
+inline
+size_t MatrixBatch<_NumericType>::cols() const { return __cols; }
+
+template<typename _NumericType>
+inline
+BatchLayout MatrixBatch<_NumericType>::layout() const { return __layout; }
+
+template<typename _NumericType>
+inline
+_NumericType* MatrixBatch<_NumericType>::begin() const { return __data.get(); }
+
+template<typename _NumericType>
+inline
+_NumericType* MatrixBatch<_NumericType>::end() const { return __data.get() + __stored() * __rows * __cols; }
+
+// Returns a reference to element (row, col) of matrix `matrix`, after checking all 3 indices.
+template<typename _NumericType>
+_NumericType& MatrixBatch<_NumericType>::operator()( const size_t matrix, const size_t row, const size_t col ) const
+{
+  if ( matrix >= __count || row >= __rows || col >= __cols )
+    throw std::out_of_range { "error: batch index out of bounds.\n" };
+
+  return __data[__index( matrix, row, col )];
+}
+
+// Copies matrix `matrix` out of the batch. Time complexity ~ O(rows*cols).
+template<typename _NumericType>
+Matrix<_NumericType> MatrixBatch<_NumericType>::get( const size_t matrix ) const
+{
+  if ( matrix >= __count )
+    throw std::out_of_range { "error: batch index out of bounds.\n" };
+
+  Matrix<_NumericType> result { __rows, __cols };
+  _NumericType* out { result.begin() };
+  for ( size_t row { 0ULL }; row < __rows; ++row )
+    for ( size_t col { 0ULL }; col < __cols; ++col )
+      *out++ = __data[__index( matrix, row, col )];
+
+  return result;
+}
+
+// Copies `mat` into position `matrix` of the batch, throws if the shapes differ. Time complexity ~ O(rows*cols).
+template<typename _NumericType>
+void MatrixBatch<_NumericType>::set( const size_t matrix, const Matrix<_NumericType>& mat )
+{
+  if ( matrix >= __count )
+    throw std::out_of_range { "error: batch index out of bounds.\n" };
+  if ( mat.rows() != __rows || mat.cols() != __cols )
+    throw std::invalid_argument { "error: source and target matrix dimensions do not match.\n" };
+
+  const _NumericType* in { mat.begin() };
+  for ( size_t row { 0ULL }; row < __rows; ++row )
+    for ( size_t col { 0ULL }; col < __cols; ++col )
+      __data[__index( matrix, row, col )] = *in++;
+}
+
+// Returns a copy of the batch in `layout`. Time complexity ~ O(count*rows*cols).
+template<typename _NumericType>
+MatrixBatch<_NumericType> MatrixBatch<_NumericType>::toLayout( const BatchLayout layout ) const
+{
+  MatrixBatch result { __count, __rows, __cols, layout };
+  for ( size_t matrix { 0ULL }; matrix < __count; ++matrix )
+    for ( size_t row { 0ULL }; row < __rows; ++row )
+      for ( size_t col { 0ULL }; col < __cols; ++col )
+        result.__data[result.__index( matrix, row, col )] = __data[__index( matrix, row, col )];
+
+  return result;
+}
+
+/* Checks the shapes, picks a kernel and runs it over the batch. Each thread gets a contiguous range of matrices
+ * (of whole groups, for the interleaved layout), so no 2 threads ever write into the same group.
+ * Small batches run on the calling thread, where starting threads would cost more than the work.
+ */
+template<typename _NumericType>
+void multiply( const MatrixBatch<_NumericType>& A, const MatrixBatch<_NumericType>& B, MatrixBatch<_NumericType>& C,
+               unsigned threads )
+{
+  if ( A.count() != B.count() || A.count() != C.count() )
+    throw std::invalid_argument { "error: batches hold different numbers of matrices.\n" };
+  if ( A.layout() != B.layout() || A.layout() != C.layout() )
+    throw std::invalid_argument { "error: batches have different layouts.\n" };
+  if ( A.cols() != B.rows() || C.rows() != A.rows() || C.cols() != B.cols() )
+    throw std::invalid_argument { "error: dimensions of multiplicand matrices are incompatible for multiplication.\n" };
+  if ( &C == &A || &C == &B )
+    throw std::invalid_argument { "error: the product batch must not be one of the multiplicand batches.\n" };
+
+  const BatchKernel<_NumericType> kernel { selectKernel<_NumericType>(
+    A.layout(), A.rows(), A.cols(), B.cols(),
+    std::make_index_sequence<maxSpecializedSize - minSpecializedSize + 1> { } ) };
+  const size_t units { A.layout() == BatchLayout::Contiguous
+    ? A.count()
+    : (A.count() + MatrixBatch<_NumericType>::groupSize - 1) / MatrixBatch<_NumericType>::groupSize };
+
+  if ( threads == 0 )
+    threads = std::max( 1U, std::thread::hardware_concurrency() );
+  threads = static_cast<unsigned>(std::min<size_t>( threads, units ));
+  if ( threads <= 1 || A.count() * A.rows() * A.cols() * B.cols() < (1ULL << 16) )
+  {
+    kernel( A.begin(), B.begin(), C.begin(), A.rows(), A.cols(), B.cols(), 0, units );
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve( threads );
+  for ( unsigned t { 0U }; t < threads; ++t )
+    workers.emplace_back( kernel, A.begin(), B.begin(), C.begin(), A.rows(), A.cols(), B.cols(),
+                          units * t / threads, units * (t + 1) / threads );
+  for ( auto& worker : workers )
+    worker.join();
+}
+
+// Template instantiations for the distinct standard arithmetic types. The `std::int_fastN_t` aliases are not used :
+// they may name the same type (all 3 are `long` with GCC on Linux), which would instantiate it twice.
+template class MatrixBatch<short>;
+template class MatrixBatch<int>;
+template class MatrixBatch<long>;
+template class MatrixBatch<long long>;
+template class MatrixBatch<float>;
+template class MatrixBatch<double>;
+template class MatrixBatch<long double>;
+template void multiply( const MatrixBatch<short>&, const MatrixBatch<short>&, MatrixBatch<short>&, unsigned );
+template void multiply( const MatrixBatch<int>&, const MatrixBatch<int>&, MatrixBatch<int>&, unsigned );
+template void multiply( const MatrixBatch<long>&, const MatrixBatch<long>&, MatrixBatch<long>&, unsigned );
+template void multiply( const MatrixBatch<long long>&, const MatrixBatch<long long>&,
+                        MatrixBatch<long long>&, unsigned );
+template void multiply( const MatrixBatch<float>&, const MatrixBatch<float>&, MatrixBatch<float>&, unsigned );
+template void multiply( const MatrixBatch<double>&, const MatrixBatch<double>&, MatrixBatch<double>&, unsigned );
+template void multiply( const MatrixBatch<long double>&, const MatrixBatch<long double>&,
+                        MatrixBatch<long double>&, unsigned );
+
+/* Times `count` independent (n x n) products as separate `Matrix` objects, and as batches in both layouts,
+ * on 1 thread and on all hardware threads. Prints millions of products per second and the largest deviation.
+ */
+static void benchmarkBatch( const size_t n, const size_t count )
+{
+  std::mt19937 generator { 2021 };
+  std::uniform_real_distribution<double> element { -1.0, 1.0 };
+
+  MatrixBatch<double> A { count, n, n }, B { count, n, n }, C { count, n, n };
+  for ( auto& el : A ) el = element( generator );
+  for ( auto& el : B ) el = element( generator );
+  std::vector<Matrix<double>> separateA, separateB, separateC;
+  for ( size_t m { 0ULL }; m < count; ++m )
+  {
+    separateA.push_back( A.get( m ) );
+    separateB.push_back( B.get( m ) );
+    separateC.emplace_back( n, n );
+  }
+  const MatrixBatch<double> interleavedA { A.toLayout( BatchLayout::Interleaved ) };
+  const MatrixBatch<double> interleavedB { B.toLayout( BatchLayout::Interleaved ) };
+  MatrixBatch<double> interleavedC { count, n, n, BatchLayout::Interleaved };
+
+  auto rate = [count] ( auto&& operation )
+  {
+    const auto start { std::chrono::steady_clock::now() };
+    operation();
+    const std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+    return count / elapsed.count() / 1e6;
+  };
+
+  const double separateRate { rate( [&]
+  {
+    for ( size_t m { 0ULL }; m < count; ++m )
+      separateC[m] = separateA[m] * separateB[m];
+  } ) };
+  const double contiguousRate { rate( [&] { multiply( A, B, C, 1 ); } ) };
+  const double interleavedRate { rate( [&] { multiply( interleavedA, interleavedB, interleavedC, 1 ); } ) };
+  const double threadedRate { rate( [&] { multiply( A, B, C ); } ) };
+
+  double deviation { 0.0 };
+  const MatrixBatch<double> interleavedAsContiguous { interleavedC.toLayout( BatchLayout::Contiguous ) };
+  for ( size_t m { 0ULL }; m < count; ++m )
+  {
+    const double* expected { separateC[m].begin() };
+    for ( size_t i { 0ULL }; i < n; ++i )
+      for ( size_t j { 0ULL }; j < n; ++j, ++expected )
+        deviation = std::max( { deviation, std::abs( *expected - C( m, i, j ) ),
+                                std::abs( *expected - interleavedAsContiguous( m, i, j ) ) } );
+  }
+
+  std::cout << std::setw( 4 ) << n << std::setw( 10 ) << count << std::setw( 12 ) << separateRate
+    << std::setw( 12 ) << contiguousRate << std::setw( 13 ) << interleavedRate << std::setw( 12 ) << threadedRate
+    << std::setw( 12 ) << deviation << '\n';
+}
+
+// Simple test function for `MatrixBatch` demo, followed by the benchmark.
+void testMatrixBatch()
+{
+  MatrixBatch<double> A { 2, 2, 2 }, B { 2, 2, 2 }, C { 2, 2, 2 };
+  A.set( 0, Matrix<double> { 2, 2, { { 1, 2 }, { 3, 4 } } } );
+  A.set( 1, Matrix<double> { 2, 2, { { 0, 1 }, { 1, 0 } } } );
+  B.set( 0, Matrix<double> { 2, 2, { { 1, 0 }, { 0, 1 } } } );
+  B.set( 1, Matrix<double> { 2, 2, { { 5, 6 }, { 7, 8 } } } );
+  multiply( A, B, C );
+  C.get( 0 ).view();                      // A[0] * identity
+  C.get( 1 ).view();                      // row swap of B[1]
+
+  std::cout << "millions of products per second\n"
+    << std::setw( 4 ) << "n" << std::setw( 10 ) << "count" << std::setw( 12 ) << "Matrix" << std::setw( 12 ) << "contiguous"
+    << std::setw( 13 ) << "interleaved" << std::setw( 12 ) << "threaded" << std::setw( 12 ) << "deviation" << '\n';
+  for ( const size_t n : { 3, 4, 5, 8, 16 } )
+    benchmarkBatch( n, (1ULL << 22) / (n * n) );
+}
\ No newline at end of file
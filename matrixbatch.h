@@ -0,0 +1,78 @@
+#ifndef __matrixbatch_h__
+#define __matrixbatch_h__
+
+#include "structs.h"        // Matrix
+
+#include <cstddef>          // std::size_t
+#include <memory>           // std::unique_ptr
+
+using size_t = std::size_t;
+
+// arrangement of the matrices of a batch in its buffer
+enum class BatchLayout
+{
+  Contiguous,               // matrix after matrix, each one row-major (array of structures)
+  Interleaved               // groups of matrices, with element (i, j) of every matrix in the group adjacent
+};
+
+/*///////////////////////////// Batch of equally shaped matrices in one contiguous buffer //////////////////////////////
+ *
+ * Millions of independent small products are better served by one allocation for the whole batch than by
+ * one `Matrix` (and one allocation per product) per matrix.
+ * In the `Contiguous` layout, matrix `m` occupies elements [m * rows * cols, (m + 1) * rows * cols).
+ * In the `Interleaved` layout, matrices are stored in groups of `groupSize`, group after group. Inside a group,
+ * element (i, j) of matrix `m` is at (i * cols + j) * groupSize + m % groupSize, so the same element of the matrices
+ * of a group is adjacent in memory, and SIMD lanes can work on different matrices at once. Keeping each group
+ * contiguous (rather than interleaving the whole batch) means a group's elements share a few pages and cache sets.
+ * The last group is padded with zero matrices, which are never exposed but do take part in products.
+ */
+template<typename _NumericType>
+class MatrixBatch
+{
+  size_t __count;                                         // number of matrices in the batch
+  size_t __rows;                                          // number of rows of every matrix
+  size_t __cols;                                          // number of columns of every matrix
+  BatchLayout __layout;                                   // arrangement of the matrices in the buffer
+  std::unique_ptr<_NumericType[]> __data;                 // all the elements of all the matrices
+
+  size_t __index( const size_t matrix, const size_t row, const size_t col ) const;  // flat index of an element
+  size_t __stored() const;                                // number of matrices in the buffer, including padding
+
+public:
+
+  static constexpr size_t groupSize { 16 };               // matrices per group in the `Interleaved` layout
+
+  MatrixBatch( const size_t count, const size_t rows, const size_t cols,
+               const BatchLayout layout = BatchLayout::Contiguous );  // zero-initialized, throws if any argument is 0
+  MatrixBatch( const MatrixBatch& copy );                 // deep copy
+  MatrixBatch( MatrixBatch&& temp ) noexcept = default;   // takes over the buffer of `temp`
+  ~MatrixBatch() = default;
+
+  size_t count() const;                                   // returns the number of matrices
+  size_t rows() const;                                    // returns the number of rows of every matrix
+  size_t cols() const;                                    // returns the number of columns of every matrix
+  BatchLayout layout() const;                             // returns the arrangement of the matrices
+  _NumericType* begin() const;                            // returns iterator to the start of the buffer
+  _NumericType* end() const;                              // returns iterator to one position after the end of the buffer
+                                                          // (includes the padding matrices of the `Interleaved` layout)
+
+  _NumericType& operator()( const size_t matrix, const size_t row, const size_t col ) const;  // bounds checked element
+  Matrix<_NumericType> get( const size_t matrix ) const;  // copies one matrix out of the batch
+  void set( const size_t matrix, const Matrix<_NumericType>& mat );   // copies one matrix into the batch
+  MatrixBatch toLayout( const BatchLayout layout ) const; // returns a copy rearranged into another layout
+};
+
+/* Multiplies every pair of corresponding matrices, C[m] = A[m] * B[m], for all m in the batch.
+ * All 3 batches must have the same count and layout, and C must already have the shape of the products.
+ * C must not be A or B : the kernels write C[m] while still reading A[m] and B[m]. Every batch owns its buffer,
+ * so distinct batches never overlap, and passing the same batch twice throws.
+ * Square sizes 2 to 16 use kernels specialized at compile time, other shapes a generic kernel.
+ * The batch is split into contiguous ranges of matrices across `threads` threads (0 = hardware concurrency).
+ */
+template<typename _NumericType>
+void multiply( const MatrixBatch<_NumericType>& A, const MatrixBatch<_NumericType>& B, MatrixBatch<_NumericType>& C,
+               unsigned threads = 0 );
+
+void testMatrixBatch();                                   // demo and benchmark against per-matrix products
+
+#endif
\ No newline at end of file
@@ -0,0 +1,421 @@
+// Implementations of file formats described in `matrixio.h`
+
+#include "matrixio.h"
+
+#include <algorithm>        // std::max
+#include <charconv>         // std::to_chars
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
+#include <cstdint>          // std::uint32_t, std::uint64_t
+#include <cstdio>           // std::remove
+#include <cstring>          // std::memcmp, std::memcpy
+#include <fstream>          // std::ofstream
+#include <iostream>         // std::cout
+#include <random>           // std::mt19937, std::uniform_real_distribution
+#include <stdexcept>        // std::out_of_range, std::runtime_error
+#include <type_traits>      // std::is_floating_point_v, std::is_signed_v
+#include <utility>          // std::exchange
+#include <vector>           // std::vector
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>        // CreateFileA, CreateFileMappingA, MapViewOfFile, UnmapViewOfFile
+#else
+#include <fcntl.h>          // open
+#include <sys/mman.h>       // mmap, munmap
+#include <sys/stat.h>       // fstat
+#include <unistd.h>         // close
+#endif
+
+static constexpr char fileMagic[8] { 'M', 'A', 'T', 'R', 'I', 'X', '\0', '\0' };
+static constexpr std::uint32_t fileVersion { 1 };
+static constexpr std::uint32_t byteOrderMarker { 0x01020304 };
+static constexpr std::uint64_t dataAlignment { 4096 };  // first row is page aligned
+static constexpr std::uint64_t rowAlignment { 64 };     // every row is cache line aligned, when possible
+
+// Maps an element type onto the kind recorded in the file header.
+template<typename _NumericType>
+static constexpr ElementKind elementKind()
+{
+  return std::is_floating_point_v<_NumericType>
+    ? ElementKind::FloatingPoint
+    : (std::is_signed_v<_NumericType> ? ElementKind::SignedInteger : ElementKind::UnsignedInteger);
+}
+
+// Number of elements per stored row, rounded up so that every row starts on a 64 byte boundary.
+static std::uint64_t rowStride( const std::uint64_t cols, const std::uint64_t elementSize )
+{
+  if ( rowAlignment % elementSize != 0 )
+    return cols;
+
+  const std::uint64_t perLine { rowAlignment / elementSize };
+  return (cols + perLine - 1) / perLine * perLine;
+}
+
+////////////////////////////////////////// Saving //////////////////////////////////////////
+
+/* Writes the header, zero padding up to the page aligned data offset, then every row followed by its padding.
+ * The stream is given a 1 MiB buffer before opening, so the many small row writes reach the OS in large blocks.
+ * Time complexity ~ O(rows*stride).
+ */
+template<typename _NumericType>
+void saveMatrix( const Matrix<_NumericType>& mat, const std::string& path )
+{
+  MatrixFileHeader header { };
+  std::memcpy( header.magic, fileMagic, sizeof( fileMagic ) );
+  header.version = fileVersion;
+  header.byteOrder = byteOrderMarker;
+  header.kind = elementKind<_NumericType>();
+  header.elementSize = sizeof( _NumericType );
+  header.rows = mat.rows();
+  header.cols = mat.cols();
+  header.stride = rowStride( header.cols, header.elementSize );
+  header.dataOffset = dataAlignment;
+
+  std::vector<char> buffer( 1ULL << 20 );
+  std::ofstream out;
+  out.rdbuf()->pubsetbuf( buffer.data(), static_cast<std::streamsize>(buffer.size()) );
+  out.open( path, std::ios::binary | std::ios::trunc );
+  if ( !out )
+    throw std::runtime_error { "error: could not open matrix file for writing.\n" };
+
+  const std::vector<char> padding( std::max( dataAlignment, (header.stride - header.cols) * header.elementSize ), '\0' );
+  out.write( reinterpret_cast<const char*>(&header), sizeof( header ) );
+  out.write( padding.data(), static_cast<std::streamsize>(header.dataOffset - sizeof( header )) );
+
+  const std::streamsize rowBytes { static_cast<std::streamsize>(header.cols * header.elementSize) };
+  const std::streamsize padBytes { static_cast<std::streamsize>((header.stride - header.cols) * header.elementSize) };
+  for ( const _NumericType* row { mat.begin() }; row != mat.end(); row += mat.cols() )
+  {
+    out.write( reinterpret_cast<const char*>(row), rowBytes );
+    out.write( padding.data(), padBytes );
+  }
+
+  out.flush();
+  if ( !out )
+    throw std::runtime_error { "error: could not write matrix file.\n" };
+}
+
+////////////////////////////////////////// MappedMatrix //////////////////////////////////////////
+
+/* Maps the whole file read-only and validates its header against `_NumericType`.
+ * No element data is read here, pages are faulted in on first access. Time complexity ~ O(1).
+ */
+template<typename _NumericType>
+MappedMatrix<_NumericType>::MappedMatrix( const std::string& path ) :
+  __mapping { nullptr },
+  __length { 0 },
+  __rows { 0 },
+  __cols { 0 },
+  __stride { 0 },
+  __data { nullptr }
+{
+#ifdef _WIN32
+  const HANDLE file { CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr ) };
+  if ( file == INVALID_HANDLE_VALUE )
+    throw std::runtime_error { "error: could not open matrix file for reading.\n" };
+
+  LARGE_INTEGER size { };
+  if ( !GetFileSizeEx( file, &size ) )
+  {
+    CloseHandle( file );
+    throw std::runtime_error { "error: could not read the size of matrix file.\n" };
+  }
+  __length = static_cast<size_t>(size.QuadPart);
+  const HANDLE mapping { __length ? CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr ) : nullptr };
+  CloseHandle( file );
+  if ( mapping )
+  {
+    __mapping = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    CloseHandle( mapping );                               // the view keeps the mapping alive
+  }
+#else
+  const int file { ::open( path.c_str(), O_RDONLY ) };
+  if ( file < 0 )
+    throw std::runtime_error { "error: could not open matrix file for reading.\n" };
+
+  struct stat status { };
+  if ( ::fstat( file, &status ) != 0 )
+  {
+    ::close( file );
+    throw std::runtime_error { "error: could not read the size of matrix file.\n" };
+  }
+  __length = static_cast<size_t>(status.st_size);
+  if ( __length )
+  {
+    void* const mapping { ::mmap( nullptr, __length, PROT_READ, MAP_PRIVATE, file, 0 ) };
+    __mapping = (mapping == MAP_FAILED) ? nullptr : mapping;
+  }
+  ::close( file );                                        // the mapping keeps the file alive
+#endif
+
+  if ( !__mapping || __length < sizeof( MatrixFileHeader ) )
+  {
+    __unmap();
+    throw std::runtime_error { "error: could not map matrix file, or file is too small.\n" };
+  }
+
+  MatrixFileHeader header;
+  std::memcpy( &header, __mapping, sizeof( header ) );
+  const char* error { nullptr };
+  // byte order before version : with the other byte order, the version reads as 0x01000000
+  if ( std::memcmp( header.magic, fileMagic, sizeof( fileMagic ) ) != 0 )
+    error = "error: not a matrix file.\n";
+  else if ( header.byteOrder != byteOrderMarker )
+    error = "error: matrix file was written with a different byte order.\n";
+  else if ( header.version != fileVersion )
+    error = "error: unsupported matrix file version.\n";
+  else if ( header.kind != elementKind<_NumericType>() || header.elementSize != sizeof( _NumericType ) )
+    error = "error: matrix file element type does not match.\n";
+  else if ( header.rows == 0 || header.cols == 0 || header.stride < header.cols ||
+            header.dataOffset < sizeof( header ) || header.dataOffset % alignof(_NumericType) != 0 ||
+            header.dataOffset > __length ||
+            header.rows > (__length - header.dataOffset) / sizeof( _NumericType ) / header.stride )
+    error = "error: matrix file header is inconsistent with its size.\n";
+
+  if ( error )
+  {
+    __unmap();
+    throw std::runtime_error { error };
+  }
+
+  __rows = static_cast<size_t>(header.rows);
+  __cols = static_cast<size_t>(header.cols);
+  __stride = static_cast<size_t>(header.stride);
+  __data = reinterpret_cast<const _NumericType*>(static_cast<const char*>(__mapping) + header.dataOffset);
+}
+
+// Takes over the mapping of `temp`, leaving it empty.
+template<typename _NumericType>
+MappedMatrix<_NumericType>::MappedMatrix( MappedMatrix&& temp ) noexcept :
+  __mapping { std::exchange( temp.__mapping, nullptr ) },
+  __length { std::exchange( temp.__length, 0 ) },
+  __rows { std::exchange( temp.__rows, 0 ) },
+  __cols { std::exchange( temp.__cols, 0 ) },
+  __stride { std::exchange( temp.__stride, 0 ) },
+  __data { std::exchange( temp.__data, nullptr ) }
+{ }
+
+template<typename _NumericType>
+MappedMatrix<_NumericType>::~MappedMatrix() { __unmap(); }
+
+// Releases the current mapping and takes over the mapping of `temp`.
+template<typename _NumericType>
+MappedMatrix<_NumericType>& MappedMatrix<_NumericType>::operator=( MappedMatrix&& temp ) noexcept
+{
+  if ( this != &temp )
+  {
+    __unmap();
+    __mapping = std::exchange( temp.__mapping, nullptr );
+    __length = std::exchange( temp.__length, 0 );
+    __rows = std::exchange( temp.__rows, 0 );
+    __cols = std::exchange( temp.__cols, 0 );
+    __stride = std::exchange( temp.__stride, 0 );
+    __data = std::exchange( temp.__data, nullptr );
+  }
+  return *this;
+}
+
+template<typename _NumericType>
+void MappedMatrix<_NumericType>::__unmap() noexcept
+{
+  if ( !__mapping ) return;
+
+#ifdef _WIN32
+  UnmapViewOfFile( __mapping );
+#else
+  ::munmap( __mapping, __length );
+#endif
+  __mapping = nullptr;
+  __data = nullptr;
+}
+
+// Returns the number of rows.
+template<typename _NumericType>
+inline
+size_t MappedMatrix<_NumericType>::rows() const { return __rows; }
+
+// Returns the number of columns.
+template<typename _NumericType>
+inline
+size_t MappedMatrix<_NumericType>::cols() const { return __cols; }
+
+// Returns the number of elements between the starts of 2 consecutive rows.
+template<typename _NumericType>
+inline
+size_t MappedMatrix<_NumericType>::stride() const { return __stride; }
+
+// Returns a pointer to the first of the `cols()` elements of a row, straight into the mapped file.
+template<typename _NumericType>
+const _NumericType* MappedMatrix<_NumericType>::operator[]( const size_t row ) const
+{
+  if ( row >= __rows )
+    throw std::out_of_range { "error: row index out of bounds.\n" };
+
+  return __data + row * __stride;
+}
+
+/* Copies the mapped rows into a new `Matrix`, dropping the row padding.
+ * Time complexity ~ O(rows*cols).
+ */
+template<typename _NumericType>
+Matrix<_NumericType> MappedMatrix<_NumericType>::toMatrix() const
+{
+  Matrix<_NumericType> result { __rows, __cols };
+  _NumericType* out { result.begin() };
+  for ( size_t row { 0ULL }; row < __rows; ++row, out += __cols )
+    std::memcpy( out, __data + row * __stride, __cols * sizeof( _NumericType ) );
+
+  return result;
+}
+
+////////////////////////////////////////// Text export //////////////////////////////////////////
+
+/* Shared implementation of `writeText`, for row pointers `data + row * stride`.
+ * The local buffer is flushed to the stream whenever less than one formatted number might still fit.
+ * Time complexity ~ O(rows*cols).
+ */
+template<typename _NumericType>
+static void writeRows( const _NumericType* const data, const size_t rows, const size_t cols, const size_t stride,
+                       std::ostream& out, const char separator )
+{
+  constexpr size_t maxNumberLength { 64 };
+  std::vector<char> buffer( 1ULL << 16 );
+  char* const bufferEnd { buffer.data() + buffer.size() };
+  char* position { buffer.data() };
+
+  for ( size_t row { 0ULL }; row < rows; ++row )
+  {
+    const _NumericType* const values { data + row * stride };
+    for ( size_t col { 0ULL }; col < cols; ++col )
+    {
+      if ( static_cast<size_t>(bufferEnd - position) < maxNumberLength )
+      {
+        out.write( buffer.data(), position - buffer.data() );
+        position = buffer.data();
+      }
+      position = std::to_chars( position, bufferEnd - 1, values[col] ).ptr;
+      *position++ = (col + 1 == cols) ? '\n' : separator;
+    }
+  }
+  out.write( buffer.data(), position - buffer.data() );
+}
+
+template<typename _NumericType>
+void writeText( const Matrix<_NumericType>& mat, std::ostream& out, const char separator )
+{
+  writeRows( static_cast<const _NumericType*>(mat.begin()), mat.rows(), mat.cols(), mat.cols(), out, separator );
+}
+
+template<typename _NumericType>
+void writeText( const MappedMatrix<_NumericType>& mat, std::ostream& out, const char separator )
+{
+  writeRows( mat[0], mat.rows(), mat.cols(), mat.stride(), out, separator );
+}
+
+// Template instantiations for the distinct standard arithmetic types. The `std::int_fastN_t` aliases are not used :
+// they may name the same type (all 3 are `long` with GCC on Linux), which would instantiate it twice.
+template class MappedMatrix<short>;
+template class MappedMatrix<int>;
+template class MappedMatrix<long>;
+template class MappedMatrix<long long>;
+template class MappedMatrix<float>;
+template class MappedMatrix<double>;
+template class MappedMatrix<long double>;
+template void saveMatrix( const Matrix<short>&, const std::string& );
+template void saveMatrix( const Matrix<int>&, const std::string& );
+template void saveMatrix( const Matrix<long>&, const std::string& );
+template void saveMatrix( const Matrix<long long>&, const std::string& );
+template void saveMatrix( const Matrix<float>&, const std::string& );
+template void saveMatrix( const Matrix<double>&, const std::string& );
+template void saveMatrix( const Matrix<long double>&, const std::string& );
+template void writeText( const Matrix<short>&, std::ostream&, const char );
+template void writeText( const Matrix<int>&, std::ostream&, const char );
+template void writeText( const Matrix<long>&, std::ostream&, const char );
+template void writeText( const Matrix<long long>&, std::ostream&, const char );
+template void writeText( const Matrix<float>&, std::ostream&, const char );
+template void writeText( const Matrix<double>&, std::ostream&, const char );
+template void writeText( const Matrix<long double>&, std::ostream&, const char );
+template void writeText( const MappedMatrix<short>&, std::ostream&, const char );
+template void writeText( const MappedMatrix<int>&, std::ostream&, const char );
+template void writeText( const MappedMatrix<long>&, std::ostream&, const char );
+template void writeText( const MappedMatrix<long long>&, std::ostream&, const char );
+template void writeText( const MappedMatrix<float>&, std::ostream&, const char );
+template void writeText( const MappedMatrix<double>&, std::ostream&, const char );
+template void writeText( const MappedMatrix<long double>&, std::ostream&, const char );
+
+
+/* Demo of a save / map / export round trip, with timings for a large matrix.
+ * Mapping time is independent of the matrix size, the first full pass over the mapped data pays for paging it in.
+ */
+void testMatrixIO()
+{
+  auto elapsedMs = [] ( auto&& operation )
+  {
+    const auto start { std::chrono::steady_clock::now() };
+    operation();
+    return std::chrono::duration<double, std::milli> { std::chrono::steady_clock::now() - start }.count();
+  };
+
+  const Matrix<double> A { 3, 3, {
+    { 1, 0.5, 1 },
+    { 0, 1, 0 },
+    { 1e-3, 0, 12345.678 }
+  } };
+  saveMatrix( A, "matrix_demo.bin" );
+  {
+    // Windows can not truncate or delete a file while a view of it is mapped, so every mapping ends in its block
+    const MappedMatrix<double> mappedA { "matrix_demo.bin" };
+    std::cout << "stride = " << mappedA.stride() << '\n';
+    mappedA.toMatrix().view();                            // testing round trip through the file
+    writeText( mappedA, std::cout );                      // testing buffered text export
+    std::cout << '\n';
+  }
+
+  constexpr size_t N { 2048 };
+  std::mt19937 generator { 2021 };
+  std::uniform_real_distribution<double> element { -1.0, 1.0 };
+  Matrix<double> B { N, N };
+  for ( auto& el : B ) el = element( generator );
+
+  const double saveMs { elapsedMs( [&] { saveMatrix( B, "matrix_demo.bin" ); } ) };
+  double mapMs, firstPassMs;
+  bool equal { true };
+  {
+    MappedMatrix<double> mappedB { "matrix_demo.bin" };
+    mapMs = elapsedMs( [&] { mappedB = MappedMatrix<double> { "matrix_demo.bin" }; } );
+    firstPassMs = elapsedMs( [&]
+    {
+      const double* original { B.begin() };
+      for ( size_t row { 0ULL }; row < N; ++row, original += N )
+        equal = equal && std::memcmp( mappedB[row], original, N * sizeof( double ) ) == 0;
+    } );
+  }                                                       // unmapped before the file is removed below
+
+  const double textMs { elapsedMs( [&]
+  {
+    std::ofstream out { "matrix_demo.txt" };
+    writeText( B, out );
+  } ) };
+  const double streamMs { elapsedMs( [&]
+  {
+    std::ofstream out { "matrix_demo.txt" };
+    out.precision( 17 );
+    for ( size_t row { 0ULL }; row < N; ++row )
+    {
+      for ( size_t col { 0ULL }; col < N; ++col )
+        out << B[row][col] << ' ';
+      out << '\n';
+    }
+  } ) };
+  std::remove( "matrix_demo.bin" );
+  std::remove( "matrix_demo.txt" );
+
+  std::cout << N << " x " << N << " doubles (" << (N * N * sizeof( double ) >> 20) << " MiB)\n"
+    << "save           : " << saveMs << " ms\n"
+    << "map            : " << mapMs << " ms\n"
+    << "first pass     : " << firstPassMs << " ms, " << (equal ? "identical" : "MISMATCH") << '\n'
+    << "text (buffered): " << textMs << " ms\n"
+    << "text (ostream) : " << streamMs << " ms\n";
+}
\ No newline at end of file
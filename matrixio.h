@@ -0,0 +1,99 @@
+#ifndef __matrixio_h__
+#define __matrixio_h__
+
+#include "structs.h"        // Matrix
+
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uint32_t, std::uint64_t
+#include <ostream>          // std::ostream
+#include <string>           // std::string
+
+using size_t = std::size_t;
+
+/*///////////////////////////////////// Binary Matrix file format ////////////////////////////////////////
+ *
+ * A file is a fixed 64 byte header followed by the raw elements, row by row, in native byte order.
+ * The first row starts at `dataOffset`, which is a multiple of 4096 so that a memory mapped view of the data
+ * is page aligned. Every row is padded to `stride` elements, so that each row starts on a 64 byte (cache line)
+ * boundary whenever the element size divides 64. Padding bytes are zero.
+ * The header records the kind and size of the element type, so a file can only be opened as the type it was
+ * saved with, and a byte order marker, so a file written on a machine of different endianness is rejected.
+ */
+enum class ElementKind : std::uint32_t
+{
+  SignedInteger = 1,
+  UnsignedInteger = 2,
+  FloatingPoint = 3
+};
+
+struct MatrixFileHeader
+{
+  char magic[8];                                          // "MATRIX\0\0"
+  std::uint32_t version;                                  // format version, currently 1
+  std::uint32_t byteOrder;                                // 0x01020304 as written by the saving machine
+  ElementKind kind;                                       // kind of element type
+  std::uint32_t elementSize;                              // sizeof element type in bytes
+  std::uint64_t rows;                                     // number of rows
+  std::uint64_t cols;                                     // number of columns
+  std::uint64_t stride;                                   // number of elements between the starts of 2 rows
+  std::uint64_t dataOffset;                               // byte offset of the first row from the start of the file
+  std::uint64_t reserved;                                 // zero, pads the header to 64 bytes
+};
+
+static_assert( sizeof( MatrixFileHeader ) == 64, "matrix file header must be exactly 64 bytes" );
+
+/* Streams `mat` into a new binary file at `path`, overwriting any existing file.
+ * Rows are written one at a time through a large stream buffer, so no copy of the whole matrix is made.
+ * Throws `std::runtime_error` if the file can not be written.
+ */
+template<typename _NumericType>
+void saveMatrix( const Matrix<_NumericType>& mat, const std::string& path );
+
+/*////////////////////////////// Read-only memory mapped view of a binary Matrix file ///////////////////////////////
+ *
+ * Opening only reads and validates the header and maps the file, so it takes constant time regardless of the
+ * matrix size. Pages of data are brought in lazily by the operating system as they are first touched.
+ * Rows are accessed in place (zero-copy), `toMatrix()` makes an owning copy when one is needed.
+ * The mapping is released when the object is destroyed, so row pointers must not outlive it.
+ */
+template<typename _NumericType>
+class MappedMatrix
+{
+  void* __mapping;                                        // start of the mapped file
+  size_t __length;                                        // length of the mapped file in bytes
+  size_t __rows;                                          // number of rows
+  size_t __cols;                                          // number of columns
+  size_t __stride;                                        // number of elements between the starts of 2 rows
+  const _NumericType* __data;                             // first element of the first row
+
+  void __unmap() noexcept;                                // releases the mapping, if any
+
+public:
+
+  explicit MappedMatrix( const std::string& path );       // maps the file, throws if it is not a valid matrix of this type
+  MappedMatrix( const MappedMatrix& ) = delete;           // disabling copy semantics, the mapping has a single owner
+  MappedMatrix( MappedMatrix&& temp ) noexcept;           // takes over the mapping of `temp`
+  ~MappedMatrix();                                        // unmaps the file
+  MappedMatrix& operator=( const MappedMatrix& ) = delete;
+  MappedMatrix& operator=( MappedMatrix&& temp ) noexcept;
+
+  size_t rows() const;                                    // returns the number of rows
+  size_t cols() const;                                    // returns the number of columns
+  size_t stride() const;                                  // returns the number of elements between the starts of 2 rows
+  const _NumericType* operator[]( const size_t row ) const;   // bounds check and returns pointer to the first element of a row
+  Matrix<_NumericType> toMatrix() const;                  // copies the mapped data into an owning `Matrix`
+};
+
+/* Writes the elements as text, one row per line, separated by `separator`.
+ * Numbers are formatted with `std::to_chars` into a large local buffer that is handed to the stream in big chunks,
+ * instead of going through formatted stream insertion once per element like `Matrix::view()`.
+ * Floating point values use the shortest representation that reads back to the same value.
+ */
+template<typename _NumericType>
+void writeText( const Matrix<_NumericType>& mat, std::ostream& out, const char separator = ' ' );
+template<typename _NumericType>
+void writeText( const MappedMatrix<_NumericType>& mat, std::ostream& out, const char separator = ' ' );
+
+void testMatrixIO();                                      // demo function
+
+#endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+// Demo of the cache described in `memocache.h`, which is fully implemented in the header
+
+#include "memocache.h"
+#include "fibonacci.h"      // fibonacci_rdp, fibonacci_idp, fibonacci_fd, fibonacci_mat
+
+#include <algorithm>        // std::max
+#include <atomic>           // std::atomic
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
+#include <cstdint>          // std::uint64_t
+#include <iomanip>          // std::setw
+#include <iostream>         // std::cout
+#include <mutex>            // std::mutex, std::lock_guard
+#include <random>           // std::mt19937_64, std::uniform_int_distribution
+#include <thread>           // std::thread
+#include <unordered_map>    // std::unordered_map
+#include <vector>           // std::vector
+
+// Runs `work( thread )` on `threads` threads at once, and returns the elapsed seconds.
+template<typename _Work>
+static double runThreads( const unsigned threads, _Work work )
+{
+  const auto start { std::chrono::steady_clock::now() };
+  std::vector<std::thread> workers;
+  for ( unsigned t { 0U }; t < threads; ++t )
+    workers.emplace_back( work, t );
+  for ( auto& worker : workers )
+    worker.join();
+  const std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+  return elapsed.count();
+}
+
+/* Hammers the memoized fibonacci functions from several threads with random counts, checking every result
+ * against `fibonacci_mat` (which keeps no state). Then times random lookups of sparse keys in a `MemoCache`
+ * against the same lookups in a `std::unordered_map` behind a `std::mutex`. Most keys live in the 2 newest of the
+ * 7 chunks, but a lookup of any other one is ruled out of the newer chunks by their filters, so the cache should
+ * be faster on a single thread already, and more so on several.
+ */
+void testMemoCache()
+{
+  const unsigned threads { std::max( 4U, std::thread::hardware_concurrency() ) };
+  constexpr size_t calls { 100'000 };
+
+  std::atomic<size_t> mismatches { 0 };
+  runThreads( threads, [&mismatches] ( const unsigned thread )
+  {
+    std::mt19937_64 generator { thread };
+    std::uniform_int_distribution<size_t> count { 0, 46 };  // F(46) is the largest that fits in `int`
+    for ( size_t i { 0 }; i < calls; ++i )
+    {
+      const size_t n { count( generator ) };
+      const int expected { fibonacci_mat( n ) };
+      if ( fibonacci_rdp( n ) != expected || fibonacci_idp( n ) != expected || fibonacci_fd( n ) != expected )
+        ++mismatches;
+    }
+  } );
+  std::cout << threads << " threads, " << threads * calls << " calls each to rdp, idp and fd : "
+    << mismatches << " wrong results\n";
+
+  // sparse keys, spread over the whole 64 bit range
+  constexpr size_t keyCount { 1 << 16 };
+  constexpr size_t lookups { 1 << 22 };
+  std::vector<std::uint64_t> keys( keyCount );
+  std::mt19937_64 generator { 2021 };
+  for ( auto& key : keys )
+    key = generator() >> 1;
+
+  MemoCache<std::uint64_t> cache;
+  std::unordered_map<std::uint64_t, std::uint64_t> map;
+  std::mutex mapMutex;
+  for ( const auto key : keys )
+  {
+    cache.insert( key, ~key );
+    map.emplace( key, ~key );
+  }
+
+  std::cout << std::setw( 10 ) << "threads" << std::setw( 22 ) << "MemoCache (M/s)"
+    << std::setw( 22 ) << "locked map (M/s)" << std::setw( 10 ) << "speedup" << '\n';
+  for ( const unsigned count : { 1U, threads } )
+  {
+    std::atomic<size_t> found { 0 };
+    const double cacheTime { runThreads( count, [&] ( const unsigned thread )
+    {
+      size_t hits { 0 };
+      for ( size_t i { thread }; i < lookups; i += count )
+        hits += cache.find( keys[(i * 7919) % keyCount] ).has_value();
+      found += hits;
+    } ) };
+    const double mapTime { runThreads( count, [&] ( const unsigned thread )
+    {
+      size_t hits { 0 };
+      for ( size_t i { thread }; i < lookups; i += count )
+      {
+        const std::lock_guard<std::mutex> lock { mapMutex };
+        hits += map.count( keys[(i * 7919) % keyCount] );
+      }
+      found += hits;
+    } ) };
+
+    std::cout << std::setw( 10 ) << count << std::setw( 22 ) << lookups / cacheTime / 1e6
+      << std::setw( 22 ) << lookups / mapTime / 1e6 << std::setw( 9 ) << mapTime / cacheTime << 'x'
+      << (found == 2 * lookups ? "" : "  MISSING KEYS") << '\n';
+  }
+}
\ No newline at end of file
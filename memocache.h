@@ -0,0 +1,223 @@
+#ifndef __memocache_h__
+#define __memocache_h__
+
+#include <atomic>           // std::atomic, std::memory_order_acquire, std::memory_order_release, ...
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uint64_t
+#include <limits>           // std::numeric_limits
+#include <memory>           // std::make_unique, std::unique_ptr
+#include <optional>         // std::optional, std::nullopt
+#include <stdexcept>        // std::invalid_argument, std::length_error
+#include <type_traits>      // std::is_default_constructible_v
+
+using size_t = std::size_t;
+
+/*////////////////////////////////// Concurrent insert-only memoization cache //////////////////////////////////
+ *
+ * Maps integer keys to values computed once, and is safe to use from any number of threads at the same time.
+ * Storage is a chain of open addressing hash tables (chunks), each 4 times as large as the one before. A full chunk
+ * is never resized or rehashed : a new, larger chunk is appended instead, so an entry never moves, and readers
+ * never see a half-moved table. Keys are hashed, so sparse keys (e.g. those of fast doubling, n, n/2, n/4, ...)
+ * take one slot each, just like dense ones.
+ * Chunks are at most half full, so that a probe ends after about 2 slots, and each has a small filter (4 bits
+ * per slot, 2 of them set per key, in one 64 bit word) that rules out about 19 chunks in 20 that do not hold a key,
+ * so a lookup of an old key seldom probes the newer chunks at all.
+ * Every slot has its own atomic key and state. Writers claim an empty slot by a compare-and-swap of its key, write
+ * the value, then publish it with a release store of the state (the filter bits are set before); readers only do
+ * acquire loads, so reads are
+ * lock-free and never wait for a writer. An entry whose value is still being written reads as missing.
+ * Entries are never removed, except by `clear`, which must not run concurrently with any other member.
+ * Values must be default constructible (empty slots hold default values), and must be deterministic for
+ * their key : 2 threads may compute the same key at once, and either result may be kept.
+ */
+template<typename _Value>
+class MemoCache
+{
+  static_assert( std::is_default_constructible_v<_Value>, "MemoCache values must be default constructible" );
+
+  static constexpr std::uint64_t __emptyKey { std::numeric_limits<std::uint64_t>::max() };   // marks unclaimed slots
+  static constexpr unsigned __firstChunkBits { 6 };       // the first chunk has 2^6 = 64 slots
+  static constexpr unsigned __maxChunks { 20 };           // chunk i has 2^(6 + 2i) slots, 2^44 for the last
+
+  struct Slot
+  {
+    std::atomic<std::uint64_t> key { __emptyKey };        // claimed by a compare-and-swap from `__emptyKey`
+    std::atomic<bool> ready { false };                    // set (release) once `value` is written
+    _Value value { };
+  };
+
+  struct Chunk
+  {
+    const unsigned bits;                                  // log2 of the number of slots
+    const size_t limit;                                   // maximum number of claimed slots, half of the slots
+    std::atomic<size_t> claimed { 0 };                    // slots reserved by writers
+    std::unique_ptr<Slot[]> slots;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> filter; // 2^(bits - 4) words, 4 bits per slot
+
+    explicit Chunk( const unsigned bits ) :
+      bits { bits },
+      limit { (size_t { 1 } << bits) / 2 },
+      slots { std::make_unique<Slot[]>( size_t { 1 } << bits ) },
+      filter { std::make_unique<std::atomic<std::uint64_t>[]>( size_t { 1 } << (bits - 4) ) }
+    { }
+  };
+
+  std::atomic<Chunk*> __chunks[__maxChunks] { };          // the chain of chunks, never reallocated
+  std::atomic<unsigned> __newest { 0 };                   // index of the chunk that receives new entries
+
+  // Fibonacci hashing : multiplying by 2^64 / golden ratio spreads consecutive keys over the whole table
+  static size_t __home( const std::uint64_t key, const unsigned bits )
+  {
+    return static_cast<size_t>((key * 0x9E37'79B9'7F4A'7C15ULL) >> (64 - bits));
+  }
+
+  /* The filter word of `key` in a chunk of 2^`bits` slots, and the 2 bits of the word set for it. The bits come from
+   * another hash than `__home`, the finalizer of MurmurHash3, so that keys sharing a home rarely share bits.
+   */
+  static std::atomic<std::uint64_t>& __filterWord( const Chunk& chunk, const std::uint64_t key, std::uint64_t& mask )
+  {
+    std::uint64_t hash { key ^ (key >> 33) };
+    hash *= 0xFF51'AFD7'ED55'8CCDULL;
+    hash ^= hash >> 33;
+    mask = (std::uint64_t { 1 } << (hash & 63)) | (std::uint64_t { 1 } << ((hash >> 6) & 63));
+    return chunk.filter[static_cast<size_t>(hash >> (64 - (chunk.bits - 4)))];
+  }
+
+  // returns the slot holding `key` in `chunk`, or nullptr if the filter or the linear probe rules it out
+  static const Slot* __probe( const Chunk& chunk, const std::uint64_t key )
+  {
+    std::uint64_t bits;
+    if ( (__filterWord( chunk, key, bits ).load( std::memory_order_acquire ) & bits) != bits ) return nullptr;
+
+    const size_t mask { (size_t { 1 } << chunk.bits) - 1 };
+    for ( size_t index { __home( key, chunk.bits ) }; ; index = (index + 1) & mask )
+    {
+      const std::uint64_t found { chunk.slots[index].key.load( std::memory_order_acquire ) };
+      if ( found == key ) return &chunk.slots[index];
+      if ( found == __emptyKey ) return nullptr;
+    }
+  }
+
+  // returns the chunk new entries go into, appending a larger one if it is full
+  Chunk* __chunkForInsert()
+  {
+    for ( ;; )
+    {
+      const unsigned newest { __newest.load( std::memory_order_acquire ) };
+      Chunk* chunk { __chunks[newest].load( std::memory_order_acquire ) };
+      if ( !chunk )
+      {
+        auto created { std::make_unique<Chunk>( __firstChunkBits + 2 * newest ) };
+        Chunk* expected { nullptr };
+        if ( __chunks[newest].compare_exchange_strong( expected, created.get(), std::memory_order_acq_rel ) )
+          chunk = created.release();
+        else
+          chunk = expected;
+      }
+
+      if ( chunk->claimed.fetch_add( 1, std::memory_order_relaxed ) < chunk->limit )
+        return chunk;
+
+      // full : undo the reservation and move on to the next chunk (whoever gets there first)
+      chunk->claimed.fetch_sub( 1, std::memory_order_relaxed );
+      if ( newest + 1 >= __maxChunks )
+        throw std::length_error { "error: MemoCache is full.\n" };
+      unsigned expected { newest };
+      __newest.compare_exchange_strong( expected, newest + 1, std::memory_order_acq_rel );
+    }
+  }
+
+public:
+
+  MemoCache() = default;
+  MemoCache( const MemoCache& ) = delete;                 // slots hold atomics and are shared between threads
+  MemoCache& operator=( const MemoCache& ) = delete;
+  ~MemoCache() { clear(); }
+
+  /* Returns the value stored for `key`, or nothing if it is missing (or still being written).
+   * Lock-free : only acquire loads. Newest chunk first, since the largest chunks hold most of the entries.
+   */
+  std::optional<_Value> find( const std::uint64_t key ) const
+  {
+    if ( key == __emptyKey )
+      throw std::invalid_argument { "error: key is reserved by MemoCache.\n" };
+
+    for ( unsigned index { __newest.load( std::memory_order_acquire ) + 1 }; index-- > 0; )
+    {
+      const Chunk* const chunk { __chunks[index].load( std::memory_order_acquire ) };
+      if ( !chunk ) continue;
+
+      if ( const Slot* const slot { __probe( *chunk, key ) } )
+      {
+        if ( slot->ready.load( std::memory_order_acquire ) )
+          return slot->value;
+        return std::nullopt;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /* Stores `value` for `key`, unless the key is already present (in which case the stored value is kept).
+   * Returns true if this call stored the value. Lock-free : writers only contend on the compare-and-swap of a slot.
+   */
+  bool insert( const std::uint64_t key, const _Value& value )
+  {
+    if ( find( key ) )
+      return false;
+
+    Chunk* const chunk { __chunkForInsert() };
+    const size_t mask { (size_t { 1 } << chunk->bits) - 1 };
+    for ( size_t index { __home( key, chunk->bits ) }; ; index = (index + 1) & mask )
+    {
+      Slot& slot { chunk->slots[index] };
+      std::uint64_t expected { __emptyKey };
+      if ( slot.key.compare_exchange_strong( expected, key, std::memory_order_acq_rel ) )
+      {
+        std::uint64_t bits;
+        __filterWord( *chunk, key, bits ).fetch_or( bits, std::memory_order_release );
+        slot.value = value;
+        slot.ready.store( true, std::memory_order_release );
+        return true;
+      }
+      if ( expected == key )                              // another thread got there first
+      {
+        chunk->claimed.fetch_sub( 1, std::memory_order_relaxed );
+        return false;
+      }
+    }
+  }
+
+  // Returns the value for `key`, calling `compute()` and storing its result if it is missing.
+  template<typename _Compute>
+  _Value getOrCompute( const std::uint64_t key, _Compute&& compute )
+  {
+    if ( std::optional<_Value> cached { find( key ) } )
+      return *cached;
+
+    const _Value value { compute() };
+    insert( key, value );
+    return value;
+  }
+
+  // Returns the number of entries, exact only when no insertion is in progress.
+  size_t size() const
+  {
+    size_t count { 0 };
+    for ( const auto& chunk : __chunks )
+      if ( const Chunk* const pointer { chunk.load( std::memory_order_acquire ) } )
+        count += pointer->claimed.load( std::memory_order_relaxed );
+    return count;
+  }
+
+  // Removes every entry and frees the chunks. NOT thread-safe : no other member may run at the same time.
+  void clear()
+  {
+    for ( auto& chunk : __chunks )
+      delete chunk.exchange( nullptr, std::memory_order_acq_rel );
+    __newest.store( 0, std::memory_order_release );
+  }
+};
+
+void testMemoCache();                                     // concurrent demo and benchmark against a locked map
+
+#endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+#ifndef __modular_h__
+#define __modular_h__
+
+#include <cstdint>          // std::uint64_t
+#include <stdexcept>        // std::invalid_argument
+
+#if !defined(__SIZEOF_INT128__) && defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>         // _umul128, _udiv128
+#endif
+
+/*////////////////////////////////////// 64 bit modular arithmetic //////////////////////////////////////
+ *
+ * Products of 64 bit residues need 128 bits. GCC and Clang provide `unsigned __int128`, MSVC on x64 provides
+ * the `_umul128` and `_udiv128` intrinsics, and everything else falls back to 32 bit halves.
+ */
+
+// Full 128 bit product of `a` and `b` : returns the high 64 bits, and writes the low 64 bits into `low`.
+inline std::uint64_t multiplyWide( const std::uint64_t a, const std::uint64_t b, std::uint64_t& low )
+{
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 product { static_cast<unsigned __int128>(a) * b };
+  low = static_cast<std::uint64_t>(product);
+  return static_cast<std::uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  std::uint64_t high;
+  low = _umul128( a, b, &high );
+  return high;
+#else
+  const std::uint64_t aLow { a & 0xFFFF'FFFFULL }, aHigh { a >> 32 };
+  const std::uint64_t bLow { b & 0xFFFF'FFFFULL }, bHigh { b >> 32 };
+  const std::uint64_t lowLow { aLow * bLow }, lowHigh { aLow * bHigh };
+  const std::uint64_t highLow { aHigh * bLow }, highHigh { aHigh * bHigh };
+  const std::uint64_t middle { (lowLow >> 32) + (lowHigh & 0xFFFF'FFFFULL) + (highLow & 0xFFFF'FFFFULL) };
+  low = (middle << 32) | (lowLow & 0xFFFF'FFFFULL);
+  return highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+#endif
+}
+
+// a * b mod m, for any `m` > 0. A 128 by 64 bit division where available, shifts and adds otherwise.
+inline std::uint64_t multiplyMod( const std::uint64_t a, const std::uint64_t b, const std::uint64_t m )
+{
+#if defined(__SIZEOF_INT128__)
+  return static_cast<std::uint64_t>(static_cast<unsigned __int128>(a) * b % m);
+#elif defined(_MSC_VER) && defined(_M_X64) && _MSC_VER >= 1920
+  std::uint64_t low;
+  const std::uint64_t high { multiplyWide( a % m, b % m, low ) };
+  std::uint64_t remainder;
+  _udiv128( high, low, m, &remainder );
+  return remainder;
+#else
+  std::uint64_t result { 0 }, addend { a % m };
+  for ( std::uint64_t bits { b % m }; bits; bits >>= 1 )
+  {
+    if ( bits & 1 )
+      result = (result >= m - addend) ? result - (m - addend) : result + addend;
+    addend = (addend >= m - addend) ? addend - (m - addend) : addend + addend;
+  }
+  return result;
+#endif
+}
+
+/*//////////////////////////////// Montgomery arithmetic modulo an odd 64 bit number ////////////////////////////////
+ *
+ * A residue x is represented as x * 2^64 mod m. In that form, the product of 2 residues is reduced by one
+ * multiplication by m^-1 mod 2^64 and one high product, instead of a 128 by 64 bit division, which is several
+ * times slower (or unavailable). Additions and subtractions are the usual modular ones.
+ * Requires an odd modulus, so that m^-1 mod 2^64 exists; even moduli have to be split off by the caller.
+ */
+class Montgomery64
+{
+  std::uint64_t __modulus;                                // m, odd
+  std::uint64_t __inverse;                                // m^-1 mod 2^64
+  std::uint64_t __one;                                    // 2^64 mod m, i.e. 1 in Montgomery form
+  std::uint64_t __rSquared;                               // 2^128 mod m, converts into Montgomery form
+
+  // (high * 2^64 + low) / 2^64 mod m, for any input below m * 2^64
+  std::uint64_t __reduce( const std::uint64_t high, const std::uint64_t low ) const
+  {
+    std::uint64_t ignored;
+    const std::uint64_t correction { multiplyWide( low * __inverse, __modulus, ignored ) };
+    return (high >= correction) ? high - correction : high - correction + __modulus;
+  }
+
+public:
+
+  Montgomery64() : Montgomery64 { 1 } { }                // modulo 1, where every value is 0
+  explicit Montgomery64( const std::uint64_t modulus ) :
+    __modulus { modulus },
+    __inverse { modulus },                                // correct to 3 bits, since m * m = 1 mod 8 for odd m
+    __one { (0 - modulus) % modulus },
+    __rSquared { 0 }
+  {
+    if ( !(modulus & 1) )
+      throw std::invalid_argument { "error: Montgomery arithmetic needs an odd modulus.\n" };
+
+    // Newton's iteration doubles the correct bits every step : 3, 6, 12, 24, 48, 96
+    for ( int i { 0 }; i < 5; ++i )
+      __inverse *= 2 - modulus * __inverse;
+
+    // 2^128 = 2^64 doubled 64 more times, each doubling reduced without overflowing 64 bits
+    __rSquared = __one;
+    for ( int i { 0 }; i < 64; ++i )
+      __rSquared = add( __rSquared, __rSquared );
+  }
+
+  std::uint64_t modulus() const { return __modulus; }
+  std::uint64_t one() const { return __one; }             // 1 in Montgomery form
+  std::uint64_t zero() const { return 0; }                // 0 in Montgomery form
+
+  std::uint64_t toMontgomery( const std::uint64_t value ) const { return multiply( value % __modulus, __rSquared ); }
+  std::uint64_t fromMontgomery( const std::uint64_t value ) const { return __reduce( 0, value ); }
+
+  std::uint64_t add( const std::uint64_t a, const std::uint64_t b ) const
+  {
+    return (a >= __modulus - b) ? a - (__modulus - b) : a + b;
+  }
+  std::uint64_t subtract( const std::uint64_t a, const std::uint64_t b ) const
+  {
+    return (a >= b) ? a - b : a + (__modulus - b);
+  }
+  std::uint64_t multiply( const std::uint64_t a, const std::uint64_t b ) const
+  {
+    std::uint64_t low;
+    const std::uint64_t high { multiplyWide( a, b, low ) };
+    return __reduce( high, low );
+  }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,249 @@
+// Implementation of the thread pool described in `parallel.h`, and the benchmark of `parallel_for`
+
+#include "parallel.h"
+#include "policy.h"         // parallelBlocks
+
+#include <algorithm>        // std::max, std::min
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
+#include <cmath>            // std::sqrt
+#include <cstdint>          // std::int64_t, std::int_fast64_t
+#include <iomanip>          // std::setw
+#include <iostream>         // std::cout
+#include <memory>           // std::make_unique
+#include <stdexcept>        // std::runtime_error
+#include <utility>          // std::move
+
+// the pool whose worker is running on this thread (null for outside threads), and the worker's queue
+static thread_local const ThreadPool* currentPool { nullptr };
+static thread_local size_t currentQueue { 0 };
+
+ThreadPool::ThreadPool( unsigned threads )
+{
+  if ( threads == 0 )
+    threads = std::max( 1U, std::thread::hardware_concurrency() );
+
+  for ( unsigned i { 0U }; i < threads; ++i )           // threads - 1 workers, and the shared queue
+    __queues.push_back( std::make_unique<WorkQueue>() );
+  for ( unsigned i { 0U }; i + 1 < threads; ++i )
+    __workers.emplace_back( &ThreadPool::__workerLoop, this, i );
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    const std::lock_guard<std::mutex> lock { __sleepMutex };
+    __stop = true;
+  }
+  __wake.notify_all();
+  for ( auto& worker : __workers )
+    worker.join();
+}
+
+unsigned ThreadPool::threads() const { return static_cast<unsigned>(__queues.size()); }
+
+// Workers use their own queue, every other thread the shared one (the last).
+size_t ThreadPool::__home() const
+{
+  return (currentPool == this) ? currentQueue : __queues.size() - 1;
+}
+
+void ThreadPool::submit( TaskGroup& group, std::function<void()> task )
+{
+  group.__pending.fetch_add( 1, std::memory_order_relaxed );
+  {
+    WorkQueue& queue { *__queues[__home()] };
+    const std::lock_guard<std::mutex> lock { queue.mutex };
+    queue.jobs.push_back( { std::move( task ), &group } );
+  }
+  __queued.fetch_add( 1, std::memory_order_release );
+
+  // taking the mutex orders this notification after the check of a worker about to sleep, so none is lost
+  { const std::lock_guard<std::mutex> lock { __sleepMutex }; }
+  __wake.notify_one();
+}
+
+/* The back of the home queue holds the newest, smallest tasks, which are likely still in this thread's cache.
+ * Thieves take the front of the other queues instead, starting after their own so they do not all pick the same one.
+ */
+bool ThreadPool::__tryRun( const size_t home )
+{
+  Job job;
+  bool found { false };
+  {
+    WorkQueue& queue { *__queues[home] };
+    const std::lock_guard<std::mutex> lock { queue.mutex };
+    if ( !queue.jobs.empty() )
+    {
+      job = std::move( queue.jobs.back() );
+      queue.jobs.pop_back();
+      found = true;
+    }
+  }
+  for ( size_t offset { 1 }; !found && offset < __queues.size(); ++offset )
+  {
+    WorkQueue& queue { *__queues[(home + offset) % __queues.size()] };
+    const std::lock_guard<std::mutex> lock { queue.mutex };
+    if ( !queue.jobs.empty() )
+    {
+      job = std::move( queue.jobs.front() );
+      queue.jobs.pop_front();
+      found = true;
+    }
+  }
+  if ( !found ) return false;
+
+  __queued.fetch_sub( 1, std::memory_order_relaxed );
+  __run( job );
+  return true;
+}
+
+void ThreadPool::__run( Job& job )
+{
+  try
+  {
+    job.task();
+  }
+  catch ( ... )
+  {
+    const std::lock_guard<std::mutex> lock { job.group->__errorMutex };
+    if ( !job.group->__error )
+      job.group->__error = std::current_exception();
+  }
+  job.group->__pending.fetch_sub( 1, std::memory_order_release );
+}
+
+void ThreadPool::__workerLoop( const size_t index )
+{
+  currentPool = this;
+  currentQueue = index;
+  for ( ;; )
+  {
+    if ( __tryRun( index ) ) continue;
+
+    std::unique_lock<std::mutex> lock { __sleepMutex };
+    __wake.wait( lock, [this] { return __stop || __queued.load( std::memory_order_acquire ) > 0; } );
+    if ( __stop && __queued.load( std::memory_order_acquire ) <= 0 ) return;
+  }
+}
+
+// The waiting thread runs tasks (of any group) until its group is done, and only yields when there is nothing to run.
+void ThreadPool::wait( TaskGroup& group )
+{
+  const size_t home { __home() };
+  while ( group.__pending.load( std::memory_order_acquire ) > 0 )
+    if ( !__tryRun( home ) )
+      std::this_thread::yield();
+
+  if ( group.__error )
+    std::rethrow_exception( group.__error );
+}
+
+ThreadPool& ThreadPool::shared()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+void parallelBlocks( const size_t count, const size_t grain, const std::function<void( size_t, size_t )>& body )
+{
+  parallelBlocks( count, grain, body, ThreadPool::shared() );
+}
+
+void parallelBlocks( const size_t count, const size_t grain, const std::function<void( size_t, size_t )>& body,
+                     ThreadPool& pool )
+{
+  using Index = std::int_fast64_t;
+  const size_t blocks { (count + grain - 1) / grain };
+  parallel_for( IntRange<Index> { static_cast<Index>(blocks) }, [count, grain, &body] ( const Index block )
+  {
+    const size_t first { static_cast<size_t>(block) * grain };
+    body( first, std::min( first + grain, count ) );
+  }, 1, pool );
+}
+
+
+// Times `run()` once, in milliseconds.
+template<typename _Run>
+static double timeMilliseconds( _Run run )
+{
+  const auto start { std::chrono::steady_clock::now() };
+  run();
+  const std::chrono::duration<double, std::milli> elapsed { std::chrono::steady_clock::now() - start };
+  return elapsed.count();
+}
+
+/* Runs the same loop serially, split statically into one `IntRange::split` part per thread, and through
+ * `parallel_for`, for 1, 2, 4, ... threads up to twice the hardware concurrency. The uniform loop costs the same for
+ * every value; the skewed one costs in proportion to the value, so the thread with the last static part gets almost
+ * twice its share and the others finish early. Then checks `parallel_reduce` against a serial sum.
+ */
+void testParallelFor()
+{
+  using Index = std::int_fast64_t;
+  constexpr Index uniformCount { 1 << 20 }, skewedCount { 1 << 13 };
+  std::vector<double> out( uniformCount );
+
+  // about 30 ns per value
+  const auto uniform { [&out] ( const Index i )
+  {
+    double x { static_cast<double>(i) };
+    for ( int k { 0 }; k < 8; ++k )
+      x = std::sqrt( x + k );
+    out[i] = x;
+  } };
+  // i / 8 steps for value i, about 0 to 1000 ns
+  const auto skewed { [&out] ( const Index i )
+  {
+    double x { static_cast<double>(i) };
+    for ( Index k { 0 }; k < i / 8; ++k )
+      x = x * 0.999 + 1.0;
+    out[i] = x;
+  } };
+
+  const unsigned hardware { std::max( 1U, std::thread::hardware_concurrency() ) };
+  std::cout << hardware << " hardware threads\n";
+  std::cout << std::setw( 10 ) << "workload" << std::setw( 10 ) << "threads" << std::setw( 14 ) << "serial (ms)"
+    << std::setw( 14 ) << "static (ms)" << std::setw( 18 ) << "parallel_for (ms)" << std::setw( 10 ) << "speedup" << '\n';
+
+  const auto benchmark { [&] ( const char* name, const IntRange<Index>& range, const auto& body )
+  {
+    const double serial { timeMilliseconds( [&] { for ( const Index i : range ) body( i ); } ) };
+    for ( unsigned threads { 1U }; threads <= 2 * hardware; threads *= 2 )
+    {
+      ThreadPool pool { threads };
+      const double statically { timeMilliseconds( [&]
+      {
+        const std::vector<IntRange<Index>> parts { range.split( threads ) };
+        std::vector<std::thread> workers;
+        for ( const auto& part : parts )
+          workers.emplace_back( [&body, part] { for ( const Index i : part ) body( i ); } );
+        for ( auto& worker : workers )
+          worker.join();
+      } ) };
+      const double stealing { timeMilliseconds( [&] { parallel_for( range, body, 0, pool ); } ) };
+      std::cout << std::setw( 10 ) << name << std::setw( 10 ) << threads << std::setw( 14 ) << serial
+        << std::setw( 14 ) << statically << std::setw( 18 ) << stealing << std::setw( 10 ) << serial / stealing << '\n';
+    }
+  } };
+  benchmark( "uniform", IntRange<Index> { uniformCount }, uniform );
+  benchmark( "skewed", IntRange<Index> { skewedCount }, skewed );
+
+  // sum of i * i, exact in 64 bits
+  const IntRange<Index> range { uniformCount };
+  std::int64_t expected { 0 };
+  for ( const Index i : range )
+    expected += i * i;
+  const std::int64_t sum { parallel_reduce( range, std::int64_t { 0 }, [] ( const Index i ) { return std::int64_t { i } * i; },
+                                            [] ( const std::int64_t a, const std::int64_t b ) { return a + b; } ) };
+  std::cout << "parallel_reduce : " << sum << (sum == expected ? " (matches)" : " MISMATCH") << '\n';
+
+  try
+  {
+    parallel_for( range, [] ( const Index i ) { if ( i == 12345 ) throw std::runtime_error { "error: thrown by value 12345.\n" }; } );
+    std::cout << "no exception from parallel_for\n";
+  }
+  catch ( const std::runtime_error& error )
+  {
+    std::cout << error.what();
+  }
+}
@@ -0,0 +1,178 @@
+#ifndef __parallel_h__
+#define __parallel_h__
+
+#include "structs.h"        // IntRange
+
+#include <atomic>           // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <cstddef>          // std::size_t, std::ptrdiff_t
+#include <deque>            // std::deque
+#include <exception>        // std::exception_ptr
+#include <functional>       // std::function
+#include <memory>           // std::unique_ptr
+#include <mutex>            // std::mutex, std::lock_guard
+#include <thread>           // std::thread
+#include <vector>           // std::vector
+
+using size_t = std::size_t;
+
+/*////////////////////////////////////////// Work-stealing thread pool //////////////////////////////////////////
+ *
+ * Every worker owns a double-ended queue of tasks. A worker pushes the tasks it creates at the back of its own queue
+ * and takes them back from there (last in, first out, so it keeps working on data still in its cache), while an idle
+ * worker steals from the front of another worker's queue, where the oldest, and for recursive splitting the largest,
+ * tasks are. Threads outside the pool submit into one more, shared queue.
+ * A pool of `threads` threads starts `threads - 1` workers : the thread waiting for a group of tasks runs tasks
+ * as well instead of blocking, so it is the last thread, and a pool of 1 thread runs everything on the caller.
+ * Waiting threads always help, so tasks may wait for tasks of their own (nested parallel loops) without deadlock.
+ * Idle workers sleep on a condition variable, and are woken by every submission.
+ */
+class ThreadPool
+{
+public:
+
+  // the unfinished tasks of one parallel loop, and the first exception thrown by any of them
+  class TaskGroup
+  {
+    friend class ThreadPool;
+
+    std::atomic<size_t> __pending { 0 };                  // submitted and not yet finished
+    std::exception_ptr __error;                           // first exception, rethrown by `wait`
+    std::mutex __errorMutex;
+  };
+
+private:
+
+  struct Job
+  {
+    std::function<void()> task;
+    TaskGroup* group;
+  };
+
+  struct WorkQueue                                        // one per worker, and a last one shared by outside threads
+  {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  std::vector<std::unique_ptr<WorkQueue>> __queues;       // never resized after construction
+  std::vector<std::thread> __workers;
+  std::atomic<std::ptrdiff_t> __queued { 0 };             // jobs in all queues, briefly negative while a push finishes
+  std::mutex __sleepMutex;
+  std::condition_variable __wake;
+  bool __stop { false };                                  // guarded by `__sleepMutex`
+
+  size_t __home() const;                                  // the queue of the calling thread
+  bool __tryRun( size_t home );                           // runs one job : own queue first, then steals
+  void __run( Job& job );                                 // runs the task, records its exception, completes it
+  void __workerLoop( size_t index );
+
+public:
+
+  explicit ThreadPool( unsigned threads = 0 );            // 0 = hardware concurrency
+  ThreadPool( const ThreadPool& ) = delete;               // workers hold a pointer to the pool
+  ThreadPool& operator=( const ThreadPool& ) = delete;
+  ~ThreadPool();                                          // finishes the queued tasks, then joins the workers
+
+  unsigned threads() const;                               // the workers and the waiting thread
+  void submit( TaskGroup& group, std::function<void()> task );   // queues a task, counted in `group`
+  void wait( TaskGroup& group );                          // runs tasks until `group` is done, then rethrows its exception
+
+  static ThreadPool& shared();                            // one pool with a thread per hardware thread, created on first use
+};
+
+/* Splits the values [first, last) of `range` in halves, queueing the upper halves as tasks that idle threads steal,
+ * down to `grain` values, then runs `leaf` on the last part. The oldest task in a queue is always the largest part
+ * left, so a thief takes a large piece of work and splits it further in its own queue : parts that turn out to be
+ * expensive get split across more threads, which balances an irregular cost per value.
+ */
+template<typename _Integer, typename _Leaf>
+void parallelSplit( ThreadPool& pool, ThreadPool::TaskGroup& group, const IntRange<_Integer>& range,
+                    const size_t first, size_t last, const size_t grain, const _Leaf& leaf )
+{
+  while ( last - first > grain )
+  {
+    const size_t middle { first + (last - first) / 2 };
+    pool.submit( group, [&pool, &group, &range, middle, last, grain, &leaf]
+    {
+      parallelSplit( pool, group, range, middle, last, grain, leaf );
+    } );
+    last = middle;
+  }
+  leaf( range.subrange( first, last - first ) );
+}
+
+// the grain used for grain 0 : about 32 parts per thread, enough to balance skewed costs by stealing
+inline size_t defaultGrain( const size_t size, const unsigned threads )
+{
+  const size_t grain { size / (static_cast<size_t>(threads) * 32) };
+  return grain ? grain : 1;
+}
+
+/* Calls `body( value )` for every value of `range`, in parallel on `pool`, and returns once every call has finished.
+ * Parts of at most `grain` values (0 = chosen from the size of the range and the number of threads) run as serial
+ * loops over an `IntRange`, which vectorize like plain index loops. Calls run in no particular order, so `body`
+ * must be safe to call concurrently for different values. The first exception thrown by `body` is rethrown here,
+ * after every other part has finished.
+ */
+template<typename _Integer, typename _Body>
+void parallel_for( const IntRange<_Integer>& range, const _Body& body, size_t grain = 0,
+                   ThreadPool& pool = ThreadPool::shared() )
+{
+  if ( range.empty() ) return;
+  if ( grain == 0 )
+    grain = defaultGrain( range.size(), pool.threads() );
+
+  const auto leaf { [&body] ( const IntRange<_Integer>& part )
+  {
+    for ( const _Integer value : part )
+      body( value );
+  } };
+  if ( pool.threads() == 1 || range.size() <= grain )
+  {
+    leaf( range );
+    return;
+  }
+
+  ThreadPool::TaskGroup group;
+  pool.submit( group, [&] { parallelSplit( pool, group, range, 0, range.size(), grain, leaf ); } );
+  pool.wait( group );
+}
+
+/* Returns identity combined with `map( value )` for every value of `range`, computed in parallel on `pool`.
+ * Every part accumulates its own result, starting from `identity`, and the parts are combined as they finish,
+ * in no particular order : `combine` must be associative and commutative (floating point sums may differ in the
+ * last bits from run to run), and `identity` neutral for it. Grain and exceptions are as for `parallel_for`.
+ */
+template<typename _Integer, typename _Value, typename _Map, typename _Combine>
+_Value parallel_reduce( const IntRange<_Integer>& range, const _Value identity, const _Map& map, const _Combine& combine,
+                        size_t grain = 0, ThreadPool& pool = ThreadPool::shared() )
+{
+  if ( grain == 0 )
+    grain = defaultGrain( range.size(), pool.threads() );
+
+  _Value result { identity };
+  std::mutex resultMutex;
+  const auto leaf { [&] ( const IntRange<_Integer>& part )
+  {
+    _Value local { identity };
+    for ( const _Integer value : part )
+      local = combine( local, map( value ) );
+    const std::lock_guard<std::mutex> lock { resultMutex };
+    result = combine( result, local );
+  } };
+  if ( pool.threads() == 1 || range.size() <= grain )
+  {
+    leaf( range );
+    return result;
+  }
+
+  ThreadPool::TaskGroup group;
+  pool.submit( group, [&] { parallelSplit( pool, group, range, 0, range.size(), grain, leaf ); } );
+  pool.wait( group );
+  return result;
+}
+
+void testParallelFor();                                   // scaling of uniform and skewed loops against static splitting
+
+#endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef __policy_h__
+#define __policy_h__
+
+#include <cstddef>          // std::size_t
+#include <execution>        // std::execution::parallel_policy, std::is_execution_policy_v, ...
+#include <functional>       // std::function
+#include <type_traits>      // std::decay_t, std::enable_if_t, std::is_same_v
+
+using size_t = std::size_t;
+
+/*///////////////////////////////////// Standard execution policies /////////////////////////////////////
+ *
+ * `sort` and `Matrix` have overloads that take a standard execution policy first, as the standard algorithms do.
+ * Only the policy types are used, never the parallel algorithms of the standard library (which need TBB with
+ * GCC) : the parallel policies run on this project's thread pool (parallel.h), `ThreadPool::shared()`.
+ * The unsequenced policies promise nothing more to these overloads, since their serial kernels are already
+ * written to vectorize : `seq` and `unseq` run the serial code, `par` and `par_unseq` the parallel code.
+ */
+
+// removes an overload unless `_ExecutionPolicy` is a standard execution policy
+template<typename _ExecutionPolicy>
+using EnableIfExecutionPolicy = std::enable_if_t<std::is_execution_policy_v<std::decay_t<_ExecutionPolicy>>>;
+
+template<typename _ExecutionPolicy>
+inline constexpr bool isParallelPolicy { std::is_same_v<std::decay_t<_ExecutionPolicy>, std::execution::parallel_policy>
+  || std::is_same_v<std::decay_t<_ExecutionPolicy>, std::execution::parallel_unsequenced_policy> };
+
+class ThreadPool;                                         // parallel.h
+
+/* Calls `body( first, last )` for consecutive blocks of at most `grain` values covering [0, count), in parallel on
+ * `pool`, or on `ThreadPool::shared()` without one, and returns once every block is done. Defined in parallel.cpp,
+ * so that headers can run parallel loops without including parallel.h (which includes structs.h, for `IntRange`).
+ */
+void parallelBlocks( size_t count, size_t grain, const std::function<void( size_t, size_t )>& body );
+void parallelBlocks( size_t count, size_t grain, const std::function<void( size_t, size_t )>& body, ThreadPool& pool );
+
+#endif
\ No newline at end of file
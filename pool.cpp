@@ -0,0 +1,223 @@
+// Implementation of the pooled array storage described in `pool.h`, and its demo
+
+#include "pool.h"
+#include "structs.h"        // Matrix
+
+#include <algorithm>        // std::max
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
+#include <iomanip>          // std::setw
+#include <iostream>         // std::cout
+#include <new>              // ::operator new, ::operator delete, std::align_val_t
+#include <vector>           // std::vector
+
+// classes up to `poolLargest` : 64 bytes, then 4 per power of 2 from 2^6 to 2^30
+constexpr size_t poolClasses { 1 + 4 * (30 - 6) };
+
+/* The class of a block of `bytes` bytes, the smallest whose size is at least `bytes`.
+ * Above 64 bytes, the sizes between 2^p (excluded) and 2^(p+1) (included) are 5, 6, 7 and 8 times 2^(p-2).
+ */
+static size_t sizeClass( const size_t bytes )
+{
+  if ( bytes <= 64 ) return 0;
+
+  size_t power { 6 };                                     // highest bit of bytes - 1
+  while ( (bytes - 1) >> (power + 1) )
+    ++power;
+  const size_t step { size_t { 1 } << (power - 2) };
+  return 1 + 4 * (power - 6) + ((bytes + step - 1) / step - 5);
+}
+
+static size_t classBytes( const size_t sizeClass )
+{
+  if ( !sizeClass ) return 64;
+  const size_t power { 6 + (sizeClass - 1) / 4 };
+  return (5 + (sizeClass - 1) % 4) << (power - 2);
+}
+
+static void* heapAllocate( const size_t bytes )
+{
+  TRACE_ALLOCATION( bytes );
+  return ::operator new( bytes, std::align_val_t { poolAlignment } );
+}
+
+static void heapFree( void* const block )
+{
+  ::operator delete( block, std::align_val_t { poolAlignment } );
+}
+
+// The free lists and statistics of one thread. Whatever the lists hold when the thread ends goes back to the heap.
+struct PoolThread
+{
+  size_t scopes { 0 };                                    // scopes open on the thread
+  std::vector<void*> freeLists[poolClasses];
+  PoolStatistics statistics { };
+
+  void release()
+  {
+    for ( auto& list : freeLists )
+    {
+      for ( void* const block : list )
+        heapFree( block );
+      statistics.heapFrees += list.size();
+      list.clear();
+    }
+    statistics.cachedBytes = 0;
+  }
+
+  ~PoolThread();
+};
+
+/* Set when the `PoolThread` of the thread is destroyed. The flag itself has no destructor, so it stays readable
+ * until the thread ends, and blocks allocated or freed by later destructors (of other static or thread_local
+ * objects) go straight to the heap instead of touching the destroyed free lists.
+ */
+static thread_local bool poolThreadEnded { false };
+
+PoolThread::~PoolThread()
+{
+  release();
+  poolThreadEnded = true;
+}
+
+static PoolThread& currentThread()
+{
+  static thread_local PoolThread thread;
+  return thread;
+}
+
+void* pool_allocate( const size_t bytes )
+{
+  if ( poolThreadEnded ) return heapAllocate( bytes );
+
+  PoolThread& thread { currentThread() };
+  ++thread.statistics.allocations;
+  if ( bytes > poolLargest )
+  {
+    ++thread.statistics.heapAllocations;
+    thread.statistics.heapBytes += bytes;
+    return heapAllocate( bytes );
+  }
+
+  const size_t index { sizeClass( bytes ) };
+  std::vector<void*>& list { thread.freeLists[index] };
+  if ( !list.empty() )
+  {
+    void* const block { list.back() };
+    list.pop_back();
+    ++thread.statistics.reused;
+    thread.statistics.cachedBytes -= classBytes( index );
+    return block;
+  }
+
+  ++thread.statistics.heapAllocations;
+  thread.statistics.heapBytes += classBytes( index );
+  return heapAllocate( classBytes( index ) );
+}
+
+void pool_free( void* const block, const size_t bytes )
+{
+  if ( !block ) return;
+  if ( poolThreadEnded )
+  {
+    heapFree( block );
+    return;
+  }
+
+  PoolThread& thread { currentThread() };
+  const size_t index { (bytes > poolLargest) ? 0 : sizeClass( bytes ) };
+  if ( !thread.scopes || bytes > poolLargest || thread.statistics.cachedBytes + classBytes( index ) > poolCacheLimit )
+  {
+    ++thread.statistics.heapFrees;
+    heapFree( block );
+    return;
+  }
+
+  thread.freeLists[index].push_back( block );
+  thread.statistics.cachedBytes += classBytes( index );
+  thread.statistics.peakCachedBytes = std::max( thread.statistics.peakCachedBytes, thread.statistics.cachedBytes );
+}
+
+PoolStatistics pool_statistics() { return currentThread().statistics; }
+
+void pool_reset_statistics()
+{
+  PoolStatistics& statistics { currentThread().statistics };
+  statistics = { 0, 0, 0, 0, 0, statistics.cachedBytes, statistics.cachedBytes, 0 };
+}
+
+PoolScope::PoolScope() :
+  __start { currentThread().statistics }
+{
+  ++currentThread().scopes;
+}
+
+PoolScope::~PoolScope()
+{
+  PoolThread& thread { currentThread() };
+  if ( --thread.scopes ) return;
+
+  thread.release();
+  ++thread.statistics.releases;
+}
+
+PoolStatistics PoolScope::statistics() const
+{
+  const PoolStatistics& now { currentThread().statistics };
+  return { now.allocations - __start.allocations, now.reused - __start.reused,
+           now.heapAllocations - __start.heapAllocations, now.heapFrees - __start.heapFrees,
+           now.heapBytes - __start.heapBytes, now.cachedBytes, now.peakCachedBytes, now.releases - __start.releases };
+}
+
+
+// Prints the counts of `statistics` on one line.
+static void printStatistics( const PoolStatistics& statistics )
+{
+  std::cout << "  " << statistics.allocations << " allocations, " << statistics.reused << " reused, "
+    << statistics.heapAllocations << " from the heap (" << statistics.heapBytes << " bytes), " << statistics.heapFrees
+    << " freed to the heap, " << statistics.cachedBytes << " bytes cached (peak " << statistics.peakCachedBytes << ")\n";
+}
+
+/* Runs the same loop of matrix arithmetic, every operation allocating its result, without and then within a scope,
+ * and prints the time per iteration and the pool statistics of both. Within the scope, only the first iteration
+ * allocates from the heap : the product packs its panels into the buffer its thread keeps (see `multiplyScratch`).
+ */
+void testPool()
+{
+  for ( const size_t n : { 4, 16, 64, 256 } )
+  {
+    Matrix<double> a { n, n }, b { n, n };
+    for ( size_t i { 0 }; i < n * n; ++i )
+    {
+      a.begin()[i] = static_cast<double>(i % 7) / n;
+      b.begin()[i] = static_cast<double>(i % 5) / n;
+    }
+
+    const size_t iterations { (n < 64) ? size_t { 100000 } : (n < 256) ? size_t { 2000 } : size_t { 100 } };
+    double sum { 0.0 };
+    const auto loop { [&]
+    {
+      const auto start { std::chrono::steady_clock::now() };
+      for ( size_t i { 0 }; i < iterations; ++i )
+      {
+        const Matrix<double> c { (a * b + a) * 0.5 - b }; // 4 temporaries
+        sum += (-c)[0][0];                                // and a fifth
+      }
+      const std::chrono::duration<double, std::nano> elapsed { std::chrono::steady_clock::now() - start };
+      return elapsed.count() / iterations;
+    } };
+
+    std::cout << n << " x " << n << '\n';
+    pool_reset_statistics();
+    const double heapTime { loop() };
+    std::cout << "without a scope : " << std::setw( 12 ) << heapTime << " ns per iteration\n";
+    printStatistics( pool_statistics() );
+    {
+      PoolScope scope;
+      const double pooledTime { loop() };
+      std::cout << "within a scope  : " << std::setw( 12 ) << pooledTime << " ns per iteration\n";
+      printStatistics( scope.statistics() );
+    }
+    std::cout << "after the scope :\n";
+    printStatistics( pool_statistics() );
+  }
+}
@@ -0,0 +1,65 @@
+// Demo and benchmark of the fixed-size matrix described in `smallmatrix.h`
+
+#include "smallmatrix.h"
+
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
+#include <iomanip>          // std::setw
+#include <iostream>         // std::cout
+#include <random>           // std::mt19937, std::uniform_real_distribution
+
+// everything below is evaluated by the compiler, no code is generated for it
+static constexpr SmallMatrix<int, 2, 2> fibonacciStep { { 1, 1 }, { 1, 0 } };
+static_assert( (fibonacciStep * fibonacciStep * fibonacciStep)[0][1] == 2, "F(3) == 2" );
+static_assert( fibonacciStep * SmallMatrix<int, 2, 2>::identity() == fibonacciStep, "M * I == M" );
+
+/* Times `iterations` chained products R = R * P for a (_Size x _Size) matrix, with both matrix types.
+ * P is a cyclic permutation matrix, so the values of R stay bounded no matter how many products are taken.
+ * Prints nanoseconds per product for the fixed-size and the dynamic matrix.
+ */
+template<size_t _Size>
+static void benchmarkProduct( const size_t iterations )
+{
+  std::mt19937 generator { 2021 };
+  std::uniform_real_distribution<double> element { -1.0, 1.0 };
+
+  SmallMatrix<double, _Size, _Size> smallR { }, smallP { };
+  for ( size_t i { 0 }; i < _Size; ++i )
+  {
+    smallP[i][(i + 1) % _Size] = 1.0;
+    for ( size_t j { 0 }; j < _Size; ++j )
+      smallR[i][j] = element( generator );
+  }
+  Matrix<double> dynamicR { smallR.toMatrix() }, dynamicP { smallP.toMatrix() };
+
+  auto start { std::chrono::steady_clock::now() };
+  for ( size_t i { 0 }; i < iterations; ++i )
+    smallR *= smallP;
+  const std::chrono::duration<double, std::nano> smallTime { std::chrono::steady_clock::now() - start };
+
+  start = std::chrono::steady_clock::now();
+  for ( size_t i { 0 }; i < iterations; ++i )
+    dynamicR *= dynamicP;
+  const std::chrono::duration<double, std::nano> dynamicTime { std::chrono::steady_clock::now() - start };
+
+  const bool same { SmallMatrix<double, _Size, _Size> { dynamicR } == smallR };
+  std::cout << std::setw( 4 ) << _Size << std::setw( 16 ) << smallTime.count() / iterations
+    << std::setw( 16 ) << dynamicTime.count() / iterations << std::setw( 10 ) << (same ? "equal" : "DIFFERENT") << '\n';
+}
+
+// Simple test function for `SmallMatrix` demo, followed by the benchmark against `Matrix`.
+void testSmallMatrix()
+{
+  constexpr SmallMatrix<double, 2, 3> A { { 1, 2, 3 }, { 4, 5, 6 } };
+  constexpr SmallMatrix<double, 3, 2> B { { 1, 0 }, { 0, 1 }, { 1, 1 } };
+  (A * B).view();                         // (2 x 3) * (3 x 2) -> (2 x 2), shape checked at compile time
+  (B * A).view();                         // (3 x 2) * (2 x 3) -> (3 x 3)
+  (2.0 * A - A).view();                   // scalar multiplication and subtraction
+
+  constexpr size_t iterations { 1'000'000 };
+  std::cout << iterations << " chained products, ns per product\n"
+    << std::setw( 4 ) << "n" << std::setw( 16 ) << "SmallMatrix" << std::setw( 16 ) << "Matrix" << '\n';
+  benchmarkProduct<2>( iterations );
+  benchmarkProduct<3>( iterations );
+  benchmarkProduct<4>( iterations );
+  benchmarkProduct<8>( iterations );
+}
\ No newline at end of file
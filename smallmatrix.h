@@ -0,0 +1,211 @@
+#ifndef __smallmatrix_h__
+#define __smallmatrix_h__
+
+#include "algos.h"          // power
+#include "structs.h"        // Matrix
+
+#include <cstddef>          // std::size_t
+#include <initializer_list> // std::initializer_list
+#include <iostream>         // std::cout
+#include <stdexcept>        // std::invalid_argument
+#include <utility>          // std::index_sequence, std::make_index_sequence
+
+using size_t = std::size_t;
+
+/*//////////////////////////// Fixed-size 2D Rectangular Array (SmallMatrix), stored inline //////////////////////////////
+ *
+ * The shape is part of the type, so the elements live directly inside the object (on the stack for locals) and
+ * no heap allocation ever happens. Dimension mismatches between operands are compile errors instead of exceptions.
+ * Every operation is `constexpr`, so small matrix computations can be evaluated entirely at compile time.
+ * The arithmetic kernels are unrolled at compile time with fold expressions over index sequences, so a 2x2 product
+ * compiles down to 8 multiplications and 4 additions with no loop overhead.
+ * Intended for small shapes (up to about 16x16); larger shapes should use the dynamic `Matrix`.
+ * Row indexing returns a plain pointer like a built-in 2D array, so `M[r][c]` is not bounds checked.
+ */
+template<typename _NumericType, size_t _Rows, size_t _Cols>
+class SmallMatrix
+{
+  static_assert( _Rows > 0 && _Cols > 0, "SmallMatrix must have at least 1 row and 1 column" );
+
+  template<typename, size_t, size_t>
+  friend class SmallMatrix;                               // access to the elements of other shapes, for multiplication
+
+  using InitializerList2D = std::initializer_list<std::initializer_list<_NumericType>>;
+
+  _NumericType __data[_Rows * _Cols];                     // the elements, row-major
+
+  // sum of products of row `row` of this and column `col` of `other`, unrolled over the inner dimension
+  template<size_t _OtherCols, size_t... _Inner>
+  constexpr _NumericType __dot( const SmallMatrix<_NumericType, _Cols, _OtherCols>& other, const size_t row,
+                                const size_t col, std::index_sequence<_Inner...> ) const
+  {
+    return ((__data[row * _Cols + _Inner] * other.__data[_Inner * _OtherCols + col]) + ...);
+  }
+
+  // every element of the product, unrolled over all the result elements
+  template<size_t _OtherCols, size_t... _Index>
+  constexpr SmallMatrix<_NumericType, _Rows, _OtherCols> __multiply( const SmallMatrix<_NumericType, _Cols, _OtherCols>& other,
+                                                                     std::index_sequence<_Index...> ) const
+  {
+    SmallMatrix<_NumericType, _Rows, _OtherCols> result { };
+    ((result.__data[_Index] = __dot( other, _Index / _OtherCols, _Index % _OtherCols,
+                                     std::make_index_sequence<_Cols> { } )), ...);
+    return result;
+  }
+
+  // applies `operation` to every pair of corresponding elements, unrolled
+  template<typename _Operation, size_t... _Index>
+  constexpr SmallMatrix __elementwise( const SmallMatrix& other, _Operation operation, std::index_sequence<_Index...> ) const
+  {
+    SmallMatrix result { };
+    ((result.__data[_Index] = operation( __data[_Index], other.__data[_Index] )), ...);
+    return result;
+  }
+
+public:
+
+  constexpr SmallMatrix() : __data { } { }               // zero-initialized matrix
+
+  /* Fills the matrix using an initializer list, rows of the list that are shorter than the matrix are
+   * zero-padded, and a list larger than the matrix throws (a compile error in constant evaluation).
+   */
+  constexpr SmallMatrix( InitializerList2D list ) :
+    __data { }
+  {
+    if ( _Rows < list.size() )
+      throw std::invalid_argument { "error: too many rows to unpack into SmallMatrix.\n" };
+
+    size_t row { 0 };
+    for ( auto innerlist : list )
+    {
+      if ( _Cols < innerlist.size() )
+        throw std::invalid_argument { "error: too many columns to unpack into SmallMatrix.\n" };
+
+      size_t col { 0 };
+      for ( auto value : innerlist )
+        __data[row * _Cols + col++] = value;
+      ++row;
+    }
+  }
+
+  // copies a dynamic `Matrix`, throws if its shape does not match
+  explicit SmallMatrix( const Matrix<_NumericType>& mat ) :
+    __data { }
+  {
+    if ( mat.rows() != _Rows || mat.cols() != _Cols )
+      throw std::invalid_argument { "error: source and target matrix dimensions do not match.\n" };
+
+    const _NumericType* value { mat.begin() };
+    for ( auto& el : __data )
+      el = *value++;
+  }
+
+  // returns the identity matrix, only defined for square shapes
+  static constexpr SmallMatrix identity()
+  {
+    static_assert( _Rows == _Cols, "identity matrix must be square" );
+    SmallMatrix result { };
+    for ( size_t i { 0 }; i < _Rows; ++i )
+      result.__data[i * _Cols + i] = _NumericType { 1 };
+    return result;
+  }
+
+  static constexpr size_t rows() { return _Rows; }        // returns the number of rows
+  static constexpr size_t cols() { return _Cols; }        // returns the number of columns
+  constexpr _NumericType* begin() { return __data; }      // returns iterator to the start of the array
+  constexpr const _NumericType* begin() const { return __data; }
+  constexpr _NumericType* end() { return __data + _Rows * _Cols; }    // returns iterator to one past the end
+  constexpr const _NumericType* end() const { return __data + _Rows * _Cols; }
+
+  constexpr _NumericType* operator[]( const size_t row ) { return __data + row * _Cols; }   // unchecked row access
+  constexpr const _NumericType* operator[]( const size_t row ) const { return __data + row * _Cols; }
+
+  constexpr SmallMatrix operator+() const { return *this; }   // unary positive operator overload
+
+  constexpr SmallMatrix operator+( const SmallMatrix& other ) const   // add 2 matrices
+  {
+    return __elementwise( other, [] ( const _NumericType a, const _NumericType b ) { return a + b; },
+                          std::make_index_sequence<_Rows * _Cols> { } );
+  }
+
+  constexpr void operator+=( const SmallMatrix& other ) { *this = *this + other; }
+
+  constexpr SmallMatrix operator-() const { return *this * _NumericType { -1 }; }     // flip the signs of all elements
+
+  constexpr SmallMatrix operator-( const SmallMatrix& other ) const   // subtract 2 matrices
+  {
+    return __elementwise( other, [] ( const _NumericType a, const _NumericType b ) { return a - b; },
+                          std::make_index_sequence<_Rows * _Cols> { } );
+  }
+
+  constexpr void operator-=( const SmallMatrix& other ) { *this = *this - other; }
+
+  // multiply 2 matrices, the inner dimensions are guaranteed to match by the types
+  template<size_t _OtherCols>
+  constexpr SmallMatrix<_NumericType, _Rows, _OtherCols> operator*( const SmallMatrix<_NumericType, _Cols, _OtherCols>& other ) const
+  {
+    return __multiply( other, std::make_index_sequence<_Rows * _OtherCols> { } );
+  }
+
+  constexpr SmallMatrix operator*( const _NumericType value ) const   // multiply scalar to every element
+  {
+    SmallMatrix result { *this };
+    for ( auto& el : result.__data )
+      el *= value;
+    return result;
+  }
+
+  // shorthand multiplication, the right-hand side has to be square to keep the shape
+  constexpr void operator*=( const SmallMatrix<_NumericType, _Cols, _Cols>& other ) { *this = *this * other; }
+
+  constexpr bool operator==( const SmallMatrix& other ) const
+  {
+    for ( size_t i { 0 }; i < _Rows * _Cols; ++i )
+      if ( !(__data[i] == other.__data[i]) )
+        return false;
+    return true;
+  }
+
+  constexpr bool operator!=( const SmallMatrix& other ) const { return !(*this == other); }
+
+  // copies the elements into a dynamic `Matrix`
+  Matrix<_NumericType> toMatrix() const
+  {
+    Matrix<_NumericType> result { _Rows, _Cols };
+    _NumericType* value { result.begin() };
+    for ( const auto el : __data )
+      *value++ = el;
+    return result;
+  }
+
+  void view() const                                       // prints the contents of the array
+  {
+    for ( size_t row { 0 }; row < _Rows; ++row )
+    {
+      for ( size_t col { 0 }; col < _Cols; ++col )
+        std::cout << __data[row * _Cols + col] << ' ';
+      std::cout << '\n';
+    }
+    std::cout << '\n';
+  }
+};
+
+// to make scalar matrix multiplication operation commutative
+template<typename _NumericType, size_t _Rows, size_t _Cols>
+constexpr SmallMatrix<_NumericType, _Rows, _Cols> operator*( const _NumericType value,
+                                                             const SmallMatrix<_NumericType, _Rows, _Cols>& mat )
+{
+  return mat * value;
+}
+
+// raise a square matrix to a power at compile time or run time, by exponentiation by squaring (see `power` in algos.h)
+template<typename _NumericType, size_t _Size>
+constexpr SmallMatrix<_NumericType, _Size, _Size> power( const SmallMatrix<_NumericType, _Size, _Size>& base,
+                                                        const std::uint64_t exp )
+{
+  return power( base, exp, SmallMatrix<_NumericType, _Size, _Size>::identity() );
+}
+
+void testSmallMatrix();                                   // demo and benchmark against the dynamic `Matrix`
+
+#endif
\ No newline at end of file
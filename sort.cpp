@@ -2,243 +2,22 @@
 
 #include <algorithm>      // sort
 #include <array>
-#include <ctime>          // time
+#include <chrono>         // steady_clock, duration
+#include <cstdlib>        // srand, rand
+#include <execution>      // seq, par, par_unseq
+#include <iomanip>        // setw
 #include <iostream>       // cin, cout
 #include <iterator>       // iterator_traits, distance
+#include <random>         // mt19937, uniform_int_distribution
 #include <utility>        // pair
 
 sort::sort( SortType type ) :
   __type { type }
 { }
 
-template<typename _Iter, typename _Pred>
-static bool sort::check( const _Iter begin, const _Iter end, _Pred pred )
-{
-  for ( _Iter i { begin }; ++i != end; )
-    if ( pred( *i, *(i - 1) ) )
-      return false;
-
-  return true;
-}
-
-template<typename _Iter, typename _Pred>
-void sort::__bubble( const _Iter begin, const _Iter end, _Pred pred )
-{
-  using diff_t = typename std::iterator_traits<_Iter>::difference_type;
-  diff_t nIters { std::distance( begin, end ) - 1 };
-  for ( diff_t i { -1 }; ++i < nIters; )
-  {
-    bool noSwaps { true };
-    _Iter _end { end - i };
-    for ( _Iter j { begin }; ++j != _end; )
-      if ( pred( *j, *(j - 1) ) )
-      {
-        std::iter_swap( j - 1, j );
-        noSwaps = false;
-      }
-
-    if ( noSwaps ) break;
-  }
-}
-
-template<typename _Iter, typename _Pred>
-void sort::__selection( const _Iter begin, const _Iter end, _Pred pred )
-{
-  for ( _Iter i { begin }; i != end; ++i )
-  {
-    _Iter key { i };
-    for ( _Iter j { i }; ++j != end; )
-      if ( pred( *j, *key ) )
-        key = j;
-
-    std::iter_swap( i, key );
-  }
-}
-
-template<typename _Iter, typename _Pred>
-void sort::__insertion( const _Iter begin, const _Iter end, _Pred pred )
-{
-  for ( _Iter current { begin }; ++current != end; )
-    for ( _Iter j { current }; j != begin && pred( *j, *(j - 1) ); --j )
-      std::iter_swap( j, j - 1 );
-}
-
-template<typename _Iter, typename _Pred>
-void sort::__merge( const _Iter begin, const _Iter end, _Pred pred )
-{
-  using diff_t = typename std::iterator_traits<_Iter>::difference_type;
-  using value_t = typename std::iterator_traits<_Iter>::value_type;
-  using buf_iter = typename std::vector<value_t>::iterator;
-
-  diff_t conSize { std::distance( begin, end ) };
-  std::vector<value_t> buffer( conSize );
-  for ( int mergeSize { 2 }; mergeSize / 2 < conSize; mergeSize <<= 1 )
-  {
-    _Iter subCon { begin };
-    buf_iter subBuf { buffer.begin() };
-    for ( ; ; subCon += mergeSize, subBuf += mergeSize )
-    {
-      bool isLastMerge { std::distance( subCon, end ) <= mergeSize };
-
-      _Iter merger { subCon };
-      const _Iter mergeEnd { isLastMerge ? end : subCon + mergeSize };
-      std::copy( subCon, mergeEnd, subBuf );
-
-      buf_iter first { subBuf };
-      const buf_iter bufMid {
-        std::distance( subBuf, buffer.end() ) <= mergeSize / 2
-        ? buffer.end()
-        : subBuf + mergeSize / 2
-      };
-      buf_iter second { bufMid };
-      const buf_iter bufEnd { isLastMerge ? buffer.end() : subBuf + mergeSize };
-
-      for ( ; merger != mergeEnd; ++merger )
-        if ( first != bufMid && second != bufEnd )
-          std::iter_swap( merger, pred( *first, *second ) ? first++ : second++ );
-        else if ( first != bufMid )
-          std::iter_swap( merger, first++ );
-        else if ( second != bufEnd )
-          std::iter_swap( merger, second++ );
-
-      if ( isLastMerge ) break;
-    }
-  }
-}
-
-template<typename _Iter, typename _Pred>
-_Iter getPivot( _Iter first, _Iter last, _Pred pred )
-{
-  auto median3 = [&pred] ( _Iter a, _Iter b, _Iter c ) -> _Iter
-  {
-    return pred( *a, *b )
-      ? (pred( *b, *c )
-          ? b
-          : (pred( *a, *c )
-              ? c
-              : a))
-      : (!pred( *b, *c )
-          ? b
-          : (!pred( *a, *c )
-              ? c
-              : a));
-  };
-
-  using diff_t = typename std::iterator_traits<_Iter>::difference_type;
-  diff_t width { 1 + std::distance( first, last ) };
-  _Iter pivot { first + width / 2 };  // pivot = midpoint
-
-  if ( width >= 50 )  // pivot = median of 3
-  {
-    if ( width >= 100 ) //  pivot = median of 9
-    {
-      first = median3( first, first + width / 8, first + width / 4 );
-      pivot = median3( pivot - width / 8, pivot, pivot + width / 8 );
-      last = median3( last - width / 4, last - width / 8, last );
-    }
-    pivot = median3( first, pivot, last );
-  }
-
-  return pivot;
-}
-
-template<typename _Iter, typename _Pred>
-void sort::__quick( const _Iter begin, const _Iter end, _Pred pred )
-{
-  vector<std::pair<_Iter, _Iter>> stack { { begin, end } };
-  while ( stack.size() != 0 )
-  {
-    auto [left, right] { stack.pop() };
-    if ( left == right || left + 1 == right ) continue;
-
-    std::iter_swap( left, getPivot( left, right - 1, pred ) );
-
-    _Iter partIdx = [&]
-    {
-      _Iter partL { left + 1 };
-      _Iter partR { right - 1 };
-      while ( true )
-      {
-        while ( pred( *partL, *left ) )
-          if ( partL + 1 == right )   // pivot is maximum value
-            return partR;
-          else
-            ++partL;
-
-        while ( !pred( *partR, *left ) )
-          if ( partR == left + 1 )        // pivot is minimum value
-            return --partR;
-          else
-            --partR;
-
-        if ( partL < partR )
-          std::iter_swap( partL, partR );
-        else
-          return partR;
-      }
-    }();
-
-    std::iter_swap( left, partIdx );
-    stack.push_back( { left, partIdx } );
-    stack.push_back( { partIdx + 1, right } );
-  }
-}
-
-template<typename _Iter, typename _Pred>
-void sort::__shell( const _Iter begin, const _Iter end, _Pred pred )
-{
-  using diff_t = typename std::iterator_traits<_Iter>::difference_type;
-  diff_t width { std::distance( begin, end ) };
-  diff_t gap { 1 };
-  while ( gap < width ) gap = 3 * gap + 1;
-  gap /= 3;
-
-  for ( ; gap > 0; gap /= 3 )
-    for ( _Iter i { begin + gap }; i != end; ++i )
-      for ( _Iter j { i };
-            std::distance( begin, j ) >= gap && pred( *j, *(j - gap) );
-            j -= gap )
-        std::iter_swap( j, j - gap );
-}
-
-template<typename _Iter, typename _Pred>
-void sort::__heap( const _Iter begin, const _Iter end, _Pred pred )
-{
-
-}
-
-template<typename _Iter, typename _Pred>
-void sort::__std( const _Iter begin, const _Iter end, _Pred pred )
-{
-  std::sort( begin, end, pred );
-}
-
-template<typename _Iter, typename _Pred>
-void sort::operator()( const _Iter begin, const _Iter end, _Pred pred )
-{
-  if ( begin == end || begin + 1 == end )
-    return;
-
-  void (sort::*selector)(_Iter, _Iter, _Pred) { nullptr };
-
-  switch ( __type )
-  {
-    case SortType::Bubble: selector = &sort::__bubble; break;
-    case SortType::Selection: selector = &sort::__selection; break;
-    case SortType::Insertion: selector = &sort::__insertion; break;
-    case SortType::Merge: selector = &sort::__merge; break;
-    case SortType::Quick: selector = &sort::__quick; break;
-    case SortType::Shell: selector = &sort::__shell; break;
-    case SortType::Heap: selector = &sort::__heap; break;
-    case SortType::STD: selector = &sort::__std; break;
-  }
-
-  (this->*selector)(begin, end, pred);
-}
-
 void testSort()
 {
-  srand( static_cast<unsigned int>(time( nullptr )) );
+  srand( 2021 );  // fixed seed, so that every run prints the same values
 
   constexpr size_t N { 100 };
   //int A[N] { };
@@ -261,3 +40,52 @@ void testSort()
     std::cout << el << ' ';
   std::cout << '\n';
 }
+
+/* Sorts the same random vector with every algorithm (but the unfinished heap sort), without a policy and under
+ * `par` and `par_unseq`, checking every result against `std::sort`. The quadratic algorithms get shorter inputs.
+ */
+void testParallelSort()
+{
+  std::mt19937 generator { 2021 };
+  std::uniform_int_distribution<int> value { 0, 1 << 30 };
+  const auto time { [] ( const auto& run )
+  {
+    const auto start { std::chrono::steady_clock::now() };
+    run();
+    const std::chrono::duration<double, std::milli> elapsed { std::chrono::steady_clock::now() - start };
+    return elapsed.count();
+  } };
+
+  const std::pair<SortType, const char*> types[] {
+    { SortType::Bubble, "bubble" }, { SortType::Selection, "selection" }, { SortType::Insertion, "insertion" },
+    { SortType::Merge, "merge" }, { SortType::Quick, "quick" }, { SortType::Shell, "shell" }, { SortType::STD, "std" }
+  };
+  std::cout << ThreadPool::shared().threads() << " threads\n" << std::setw( 10 ) << "sort" << std::setw( 10 ) << "size"
+    << std::setw( 14 ) << "serial (ms)" << std::setw( 14 ) << "par (ms)" << std::setw( 16 ) << "par_unseq (ms)"
+    << std::setw( 10 ) << "sorted" << '\n';
+  for ( const auto& [type, name] : types )
+  {
+    const size_t size { (type <= SortType::Insertion) ? size_t { 1 } << 14 : size_t { 1 } << 22 };
+    std::vector<int> input( size );
+    for ( auto& element : input )
+      element = value( generator );
+    std::vector<int> expected { input };
+    std::sort( expected.begin(), expected.end() );
+
+    sort sorter { type };
+    bool sorted { true };
+    std::vector<int> data;
+    const auto run { [&] ( const auto& sortData )
+    {
+      data = input;
+      const double elapsed { time( sortData ) };
+      sorted = sorted && data == expected;
+      return elapsed;
+    } };
+    const double serial { run( [&] { sorter( data.begin(), data.end() ); } ) };
+    const double parallel { run( [&] { sorter( std::execution::par, data.begin(), data.end() ); } ) };
+    const double unsequenced { run( [&] { sorter( std::execution::par_unseq, data.begin(), data.end() ); } ) };
+    std::cout << std::setw( 10 ) << name << std::setw( 10 ) << size << std::setw( 14 ) << serial << std::setw( 14 )
+      << parallel << std::setw( 16 ) << unsequenced << std::setw( 10 ) << std::boolalpha << sorted << '\n';
+  }
+}
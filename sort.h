@@ -1,7 +1,15 @@
 #ifndef __sort_h__
 #define __sort_h__
 
+#include "parallel.h"     // ThreadPool, parallel_for, IntRange
+#include "policy.h"       // EnableIfExecutionPolicy, isParallelPolicy
+#include "trace.h"        // TRACE_SCOPE, TRACE_ALLOCATION, TRACE_MOVED
+
+#include <algorithm>      // std::copy, std::inplace_merge, std::iter_swap, std::min, std::sort
+#include <cstddef>        // std::ptrdiff_t
 #include <functional>     // std::less
+#include <iterator>       // std::distance, std::iterator_traits
+#include <utility>        // std::pair
 #include <vector>
 
 enum class SortType
@@ -59,8 +67,302 @@ public:
 
   template<typename _Iter, typename _Pred = std::less<>>
   void operator()( const _Iter begin, const _Iter _end, _Pred pred = std::less<> {} );
+
+  /* The same sort under a standard execution policy (see policy.h). With `par` and `par_unseq`, the range is cut
+   * into one part per thread of `ThreadPool::shared()`, the parts are sorted by this sorter's algorithm in
+   * parallel, then merged pairwise in parallel rounds by `std::inplace_merge`. Quadratic algorithms also do less
+   * work in total, since every part is shorter. `seq` and `unseq` are the same as no policy.
+   */
+  template<typename _ExecutionPolicy, typename _Iter, typename _Pred = std::less<>,
+           typename = EnableIfExecutionPolicy<_ExecutionPolicy>>
+  void operator()( _ExecutionPolicy&& policy, const _Iter begin, const _Iter _end, _Pred pred = std::less<> {} );
 };
 
+constexpr std::ptrdiff_t parallelSortMinimum { 1 << 13 }; // elements per part, below which a parallel sort is serial
+
+// std::iter_swap, counted in the trace as the 3 moves of a swap
+template<typename _Iter>
+inline void tracedSwap( const _Iter a, const _Iter b )
+{
+  TRACE_MOVED( 3 * sizeof( *a ) );
+  std::iter_swap( a, b );
+}
+
+template<typename _Iter, typename _Pred>
+bool sort::check( const _Iter begin, const _Iter end, _Pred pred )
+{
+  for ( _Iter i { begin }; ++i != end; )
+    if ( pred( *i, *(i - 1) ) )
+      return false;
+
+  return true;
+}
+
+template<typename _Iter, typename _Pred>
+void sort::__bubble( const _Iter begin, const _Iter end, _Pred pred )
+{
+  TRACE_SCOPE( "sort::bubble" );
+  using diff_t = typename std::iterator_traits<_Iter>::difference_type;
+  diff_t nIters { std::distance( begin, end ) - 1 };
+  for ( diff_t i { -1 }; ++i < nIters; )
+  {
+    bool noSwaps { true };
+    _Iter _end { end - i };
+    for ( _Iter j { begin }; ++j != _end; )
+      if ( pred( *j, *(j - 1) ) )
+      {
+        tracedSwap( j - 1, j );
+        noSwaps = false;
+      }
+
+    if ( noSwaps ) break;
+  }
+}
+
+template<typename _Iter, typename _Pred>
+void sort::__selection( const _Iter begin, const _Iter end, _Pred pred )
+{
+  TRACE_SCOPE( "sort::selection" );
+  for ( _Iter i { begin }; i != end; ++i )
+  {
+    _Iter key { i };
+    for ( _Iter j { i }; ++j != end; )
+      if ( pred( *j, *key ) )
+        key = j;
+
+    tracedSwap( i, key );
+  }
+}
+
+template<typename _Iter, typename _Pred>
+void sort::__insertion( const _Iter begin, const _Iter end, _Pred pred )
+{
+  TRACE_SCOPE( "sort::insertion" );
+  for ( _Iter current { begin }; ++current != end; )
+    for ( _Iter j { current }; j != begin && pred( *j, *(j - 1) ); --j )
+      tracedSwap( j, j - 1 );
+}
+
+template<typename _Iter, typename _Pred>
+void sort::__merge( const _Iter begin, const _Iter end, _Pred pred )
+{
+  TRACE_SCOPE( "sort::merge" );
+  using diff_t = typename std::iterator_traits<_Iter>::difference_type;
+  using value_t = typename std::iterator_traits<_Iter>::value_type;
+  using buf_iter = typename std::vector<value_t>::iterator;
+
+  diff_t conSize { std::distance( begin, end ) };
+  std::vector<value_t> buffer( conSize );
+  TRACE_ALLOCATION( conSize * sizeof( value_t ) );
+  for ( int mergeSize { 2 }; mergeSize / 2 < conSize; mergeSize <<= 1 )
+  {
+    _Iter subCon { begin };
+    buf_iter subBuf { buffer.begin() };
+    for ( ; ; subCon += mergeSize, subBuf += mergeSize )
+    {
+      bool isLastMerge { std::distance( subCon, end ) <= mergeSize };
+
+      _Iter merger { subCon };
+      const _Iter mergeEnd { isLastMerge ? end : subCon + mergeSize };
+      std::copy( subCon, mergeEnd, subBuf );
+      TRACE_MOVED( std::distance( subCon, mergeEnd ) * sizeof( value_t ) );
+
+      buf_iter first { subBuf };
+      const buf_iter bufMid {
+        std::distance( subBuf, buffer.end() ) <= mergeSize / 2
+        ? buffer.end()
+        : subBuf + mergeSize / 2
+      };
+      buf_iter second { bufMid };
+      const buf_iter bufEnd { isLastMerge ? buffer.end() : subBuf + mergeSize };
+
+      for ( ; merger != mergeEnd; ++merger )
+        if ( first != bufMid && second != bufEnd )
+          tracedSwap( merger, pred( *first, *second ) ? first++ : second++ );
+        else if ( first != bufMid )
+          tracedSwap( merger, first++ );
+        else if ( second != bufEnd )
+          tracedSwap( merger, second++ );
+
+      if ( isLastMerge ) break;
+    }
+  }
+}
+
+template<typename _Iter, typename _Pred>
+inline _Iter getPivot( _Iter first, _Iter last, _Pred pred )
+{
+  auto median3 = [&pred] ( _Iter a, _Iter b, _Iter c ) -> _Iter
+  {
+    return pred( *a, *b )
+      ? (pred( *b, *c )
+          ? b
+          : (pred( *a, *c )
+              ? c
+              : a))
+      : (!pred( *b, *c )
+          ? b
+          : (!pred( *a, *c )
+              ? c
+              : a));
+  };
+
+  using diff_t = typename std::iterator_traits<_Iter>::difference_type;
+  diff_t width { 1 + std::distance( first, last ) };
+  _Iter pivot { first + width / 2 };  // pivot = midpoint
+
+  if ( width >= 50 )  // pivot = median of 3
+  {
+    if ( width >= 100 ) //  pivot = median of 9
+    {
+      first = median3( first, first + width / 8, first + width / 4 );
+      pivot = median3( pivot - width / 8, pivot, pivot + width / 8 );
+      last = median3( last - width / 4, last - width / 8, last );
+    }
+    pivot = median3( first, pivot, last );
+  }
+
+  return pivot;
+}
+
+template<typename _Iter, typename _Pred>
+void sort::__quick( const _Iter begin, const _Iter end, _Pred pred )
+{
+  TRACE_SCOPE( "sort::quick" );
+  vector<std::pair<_Iter, _Iter>> stack { { begin, end } };
+  while ( stack.size() != 0 )
+  {
+    auto [left, right] { stack.pop() };
+    if ( left == right || left + 1 == right ) continue;
+
+    tracedSwap( left, getPivot( left, right - 1, pred ) );
+
+    _Iter partIdx = [&]
+    {
+      _Iter partL { left + 1 };
+      _Iter partR { right - 1 };
+      while ( true )
+      {
+        while ( pred( *partL, *left ) )
+          if ( partL + 1 == right )   // pivot is maximum value
+            return partR;
+          else
+            ++partL;
+
+        while ( !pred( *partR, *left ) )
+          if ( partR == left + 1 )        // pivot is minimum value
+            return --partR;
+          else
+            --partR;
+
+        if ( partL < partR )
+          tracedSwap( partL, partR );
+        else
+          return partR;
+      }
+    }();
+
+    tracedSwap( left, partIdx );
+    stack.push_back( { left, partIdx } );
+    stack.push_back( { partIdx + 1, right } );
+  }
+}
+
+template<typename _Iter, typename _Pred>
+void sort::__shell( const _Iter begin, const _Iter end, _Pred pred )
+{
+  TRACE_SCOPE( "sort::shell" );
+  using diff_t = typename std::iterator_traits<_Iter>::difference_type;
+  diff_t width { std::distance( begin, end ) };
+  diff_t gap { 1 };
+  while ( gap < width ) gap = 3 * gap + 1;
+  gap /= 3;
+
+  for ( ; gap > 0; gap /= 3 )
+    for ( _Iter i { begin + gap }; i != end; ++i )
+      for ( _Iter j { i };
+            std::distance( begin, j ) >= gap && pred( *j, *(j - gap) );
+            j -= gap )
+        tracedSwap( j, j - gap );
+}
+
+template<typename _Iter, typename _Pred>
+void sort::__heap( const _Iter begin, const _Iter end, _Pred pred )
+{
+  TRACE_SCOPE( "sort::heap" );
+
+}
+
+template<typename _Iter, typename _Pred>
+void sort::__std( const _Iter begin, const _Iter end, _Pred pred )
+{
+  TRACE_SCOPE( "sort::std" );
+  std::sort( begin, end, pred );
+}
+
+template<typename _Iter, typename _Pred>
+void sort::operator()( const _Iter begin, const _Iter end, _Pred pred )
+{
+  if ( begin == end || begin + 1 == end )
+    return;
+
+  void (sort::*selector)(_Iter, _Iter, _Pred) { nullptr };
+
+  switch ( __type )
+  {
+    case SortType::Bubble: selector = &sort::__bubble; break;
+    case SortType::Selection: selector = &sort::__selection; break;
+    case SortType::Insertion: selector = &sort::__insertion; break;
+    case SortType::Merge: selector = &sort::__merge; break;
+    case SortType::Quick: selector = &sort::__quick; break;
+    case SortType::Shell: selector = &sort::__shell; break;
+    case SortType::Heap: selector = &sort::__heap; break;
+    case SortType::STD: selector = &sort::__std; break;
+  }
+
+  (this->*selector)(begin, end, pred);
+}
+
+
+/* Below `parallelSortMinimum` elements per thread, threads would cost more than they save. The merges need
+ * random access iterators, as every algorithm of `sort` already does.
+ */
+template<typename _ExecutionPolicy, typename _Iter, typename _Pred, typename>
+void sort::operator()( _ExecutionPolicy&&, const _Iter begin, const _Iter end, _Pred pred )
+{
+  if constexpr ( !isParallelPolicy<_ExecutionPolicy> )
+    (*this)( begin, end, pred );
+  else
+  {
+    using Index = std::ptrdiff_t;
+    ThreadPool& pool { ThreadPool::shared() };
+    const Index size { std::distance( begin, end ) };
+    const Index parts { std::min<Index>( pool.threads(), size / parallelSortMinimum ) };
+    if ( parts <= 1 )
+    {
+      (*this)( begin, end, pred );
+      return;
+    }
+
+    TRACE_SCOPE( "sort::parallel" );
+    const auto boundary { [begin, size, parts] ( const Index part ) { return begin + size * part / parts; } };
+    parallel_for( IntRange<Index> { parts }, [&] ( const Index part )
+    {
+      (*this)( boundary( part ), boundary( part + 1 ), pred );
+    }, 1, pool );
+
+    // rounds of merges of neighbouring runs : parts 2i and 2i+1, then 4i and 4i+2, ... until one run is left
+    for ( Index width { 1 }; width < parts; width *= 2 )
+      parallel_for( IntRange<Index> { 0, parts - width, 2 * width }, [&] ( const Index first )
+      {
+        std::inplace_merge( boundary( first ), boundary( first + width ),
+                            boundary( std::min( first + 2 * width, parts ) ), pred );
+      }, 1, pool );
+  }
+}
+
+
 void testSort();
+void testParallelSort();                                  // the algorithms under each execution policy
 
 #endif
\ No newline at end of file
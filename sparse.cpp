@@ -0,0 +1,424 @@
+// Implementations of data structures described in `sparse.h`
+
+#include "sparse.h"
+
+#include <algorithm>        // std::max, std::min, std::sort, std::upper_bound
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
+#include <cmath>            // std::abs
+#include <iomanip>          // std::setw, std::setprecision
+#include <iostream>         // std::cout
+#include <limits>           // std::numeric_limits
+#include <optional>         // std::optional
+#include <random>           // std::mt19937, std::uniform_real_distribution, std::bernoulli_distribution
+#include <stdexcept>        // std::invalid_argument, std::out_of_range
+#include <thread>           // std::thread
+
+/* Multiplies the CSR rows [rowBegin, rowEnd) into the dense (rows x n) result.
+ * For SpMV (n == 1) the dot product of each row is accumulated in a register and written once.
+ * For SpMM every stored element scales one contiguous row of `dense`, so both inputs are streamed in memory order.
+ * `result` is expected to be zero-initialized. Time complexity ~ O(nnz(rows) * n).
+ */
+template<typename _NumericType>
+static void multiplyCSRRows( const size_t* const offsets, const size_t* const indices, const _NumericType* const values,
+                             const _NumericType* const dense, _NumericType* const result, const size_t n,
+                             const size_t rowBegin, const size_t rowEnd )
+{
+  if ( n == 1 )
+  {
+    for ( size_t row { rowBegin }; row < rowEnd; ++row )
+    {
+      _NumericType sum { };
+      for ( size_t k { offsets[row] }; k < offsets[row + 1]; ++k )
+        sum += values[k] * dense[indices[k]];
+      result[row] = sum;
+    }
+    return;
+  }
+
+  for ( size_t row { rowBegin }; row < rowEnd; ++row )
+  {
+    _NumericType* const out { result + row * n };
+    for ( size_t k { offsets[row] }; k < offsets[row + 1]; ++k )
+    {
+      const _NumericType value { values[k] };
+      const _NumericType* const in { dense + indices[k] * n };
+      for ( size_t col { 0ULL }; col < n; ++col )
+        out[col] += value * in[col];
+    }
+  }
+}
+
+/* Multiplies the CSC matrix into the dense (rows x n) result.
+ * Every stored element (i, j) scatters row `j` of `dense` into row `i` of the result.
+ * `result` is expected to be zero-initialized. Time complexity ~ O(nnz * n).
+ */
+template<typename _NumericType>
+static void multiplyCSC( const size_t* const offsets, const size_t* const indices, const _NumericType* const values,
+                         const _NumericType* const dense, _NumericType* const result, const size_t n, const size_t cols )
+{
+  for ( size_t col { 0ULL }; col < cols; ++col )
+  {
+    const _NumericType* const in { dense + col * n };
+    for ( size_t k { offsets[col] }; k < offsets[col + 1]; ++k )
+    {
+      const _NumericType value { values[k] };
+      _NumericType* const out { result + indices[k] * n };
+      for ( size_t c { 0ULL }; c < n; ++c )
+        out[c] += value * in[c];
+    }
+  }
+}
+
+//////////////////////////////////// Compressed Sparse Matrix //////////////////////////////////////
+
+// Constructs an empty (all zeros) matrix with the given shape, throws an exception if either dimension is 0.
+template<typename _NumericType>
+SparseMatrix<_NumericType>::SparseMatrix( const size_t rows, const size_t cols, const SparseFormat format ) :
+  __format { format },
+  __rows { rows },
+  __cols { cols },
+  __offsets( (format == SparseFormat::CSR ? rows : cols) + 1, 0 )
+{
+  if ( rows == 0 || cols == 0 )
+    throw std::invalid_argument { "error: matrix has either 0 rows or 0 columns or both.\n" };
+}
+
+// Returns the number of compressed rows (CSR) or columns (CSC).
+template<typename _NumericType>
+inline
+size_t SparseMatrix<_NumericType>::__major() const { return __format == SparseFormat::CSR ? __rows : __cols; }
+
+/* Compresses a dense matrix, storing only the elements that compare unequal to zero.
+ * Dense elements are visited in the storage order of `format`, so the indices come out sorted.
+ * Time complexity ~ O(rows*cols).
+ */
+template<typename _NumericType>
+SparseMatrix<_NumericType>::SparseMatrix( const Matrix<_NumericType>& dense, const SparseFormat format ) :
+  SparseMatrix { dense.rows(), dense.cols(), format }
+{
+  const _NumericType* const data { dense.begin() };
+  const size_t major { __major() };
+  const size_t minor { format == SparseFormat::CSR ? __cols : __rows };
+  for ( size_t i { 0ULL }; i < major; ++i )
+  {
+    for ( size_t j { 0ULL }; j < minor; ++j )
+    {
+      const _NumericType value { format == SparseFormat::CSR ? data[i * __cols + j] : data[j * __cols + i] };
+      if ( value != _NumericType { } )
+      {
+        __indices.push_back( j );
+        __values.push_back( value );
+      }
+    }
+    __offsets[i + 1] = __indices.size();
+  }
+}
+
+/* Builds the matrix from coordinate (COO) triplets given in any order.
+ * Triplets with the same position are summed, and positions that sum to zero are not stored.
+ * Throws an exception if a triplet lies outside the given shape.
+ * Time complexity ~ O(nnz * log(nnz)) for sorting the triplets.
+ */
+template<typename _NumericType>
+SparseMatrix<_NumericType>::SparseMatrix( const size_t rows, const size_t cols,
+                                          const std::vector<Triplet<_NumericType>>& triplets,
+                                          const SparseFormat format ) :
+  SparseMatrix { rows, cols, format }
+{
+  const bool isCSR { format == SparseFormat::CSR };
+  std::vector<Triplet<_NumericType>> sorted { triplets };
+  for ( const auto& entry : sorted )
+    if ( entry.row >= rows || entry.col >= cols )
+      throw std::out_of_range { "error: triplet index out of bounds.\n" };
+
+  std::sort( sorted.begin(), sorted.end(), [isCSR] ( const auto& a, const auto& b )
+  {
+    return isCSR
+      ? (a.row < b.row || (a.row == b.row && a.col < b.col))
+      : (a.col < b.col || (a.col == b.col && a.row < b.row));
+  } );
+
+  __indices.reserve( sorted.size() );
+  __values.reserve( sorted.size() );
+  for ( size_t i { 0ULL }; i < sorted.size(); )
+  {
+    const size_t major { isCSR ? sorted[i].row : sorted[i].col };
+    const size_t minor { isCSR ? sorted[i].col : sorted[i].row };
+    _NumericType sum { };
+    for ( ; i < sorted.size() &&
+            (isCSR ? sorted[i].row : sorted[i].col) == major &&
+            (isCSR ? sorted[i].col : sorted[i].row) == minor; ++i )
+      sum += sorted[i].value;
+
+    if ( sum != _NumericType { } )
+    {
+      __indices.push_back( minor );
+      __values.push_back( sum );
+      ++__offsets[major + 1];
+    }
+  }
+
+  // counts per row (column) into starting offsets
+  for ( size_t i { 0ULL }; i < __major(); ++i )
+    __offsets[i + 1] += __offsets[i];
+}
+
+// Returns the number of rows.
+template<typename _NumericType>
+inline
+size_t SparseMatrix<_NumericType>::rows() const { return __rows; }
+
+// Returns the number of columns.
+template<typename _NumericType>
+inline
+size_t SparseMatrix<_NumericType>::cols() const { return __cols; }
+
+// Returns the number of stored (non-zero) elements.
+template<typename _NumericType>
+inline
+size_t SparseMatrix<_NumericType>::nonZeros() const { return __values.size(); }
+
+// Returns the storage order of the compressed arrays.
+template<typename _NumericType>
+inline
+SparseFormat SparseMatrix<_NumericType>::format() const { return __format; }
+
+/* Returns a row-major copy. If the matrix is already CSR, this is a plain copy.
+ * Otherwise, the compressed arrays are transposed with a counting sort: count the elements of every row,
+ * turn the counts into offsets, then scatter the columns in order, which keeps each row's indices sorted.
+ * Time complexity ~ O(rows + cols + nnz).
+ */
+template<typename _NumericType>
+SparseMatrix<_NumericType> SparseMatrix<_NumericType>::toCSR() const
+{
+  if ( __format == SparseFormat::CSR ) return *this;
+
+  SparseMatrix result { __rows, __cols, SparseFormat::CSR };
+  result.__indices.resize( nonZeros() );
+  result.__values.resize( nonZeros() );
+  for ( const auto row : __indices )
+    ++result.__offsets[row + 1];
+  for ( size_t row { 0ULL }; row < __rows; ++row )
+    result.__offsets[row + 1] += result.__offsets[row];
+
+  std::vector<size_t> next { result.__offsets.begin(), result.__offsets.end() - 1 };
+  for ( size_t col { 0ULL }; col < __cols; ++col )
+    for ( size_t k { __offsets[col] }; k < __offsets[col + 1]; ++k )
+    {
+      const size_t position { next[__indices[k]]++ };
+      result.__indices[position] = col;
+      result.__values[position] = __values[k];
+    }
+
+  return result;
+}
+
+/* Returns a column-major copy, mirroring `toCSR`.
+ * Time complexity ~ O(rows + cols + nnz).
+ */
+template<typename _NumericType>
+SparseMatrix<_NumericType> SparseMatrix<_NumericType>::toCSC() const
+{
+  if ( __format == SparseFormat::CSC ) return *this;
+
+  SparseMatrix result { __rows, __cols, SparseFormat::CSC };
+  result.__indices.resize( nonZeros() );
+  result.__values.resize( nonZeros() );
+  for ( const auto col : __indices )
+    ++result.__offsets[col + 1];
+  for ( size_t col { 0ULL }; col < __cols; ++col )
+    result.__offsets[col + 1] += result.__offsets[col];
+
+  std::vector<size_t> next { result.__offsets.begin(), result.__offsets.end() - 1 };
+  for ( size_t row { 0ULL }; row < __rows; ++row )
+    for ( size_t k { __offsets[row] }; k < __offsets[row + 1]; ++k )
+    {
+      const size_t position { next[__indices[k]]++ };
+      result.__indices[position] = row;
+      result.__values[position] = __values[k];
+    }
+
+  return result;
+}
+
+/* Expands the stored elements into a zero-initialized dense matrix.
+ * Time complexity ~ O(rows*cols + nnz).
+ */
+template<typename _NumericType>
+Matrix<_NumericType> SparseMatrix<_NumericType>::toDense() const
+{
+  Matrix<_NumericType> result { __rows, __cols };
+  _NumericType* const data { result.begin() };
+  for ( size_t i { 0ULL }; i < __major(); ++i )
+    for ( size_t k { __offsets[i] }; k < __offsets[i + 1]; ++k )
+      if ( __format == SparseFormat::CSR )
+        data[i * __cols + __indices[k]] = __values[k];
+      else
+        data[__indices[k] * __cols + i] = __values[k];
+
+  return result;
+}
+
+/* Overload for multiplying with a dense matrix (SpMM), or a dense (n x 1) vector (SpMV), on the calling thread.
+ * Checks the matrix multiplication dimensions prerequisite. Zeros of the sparse operand are never touched.
+ * Time complexity ~ O(nnz * dense.cols()), compared to O(rows*cols*dense.cols()) for dense multiplication.
+ */
+template<typename _NumericType>
+Matrix<_NumericType> SparseMatrix<_NumericType>::operator*( const Matrix<_NumericType>& dense ) const
+{
+  if ( __cols != dense.rows() )
+    throw std::invalid_argument { "error: dimensions of multiplicand matrices are incompatible for multiplication.\n" };
+
+  Matrix<_NumericType> result { __rows, dense.cols() };
+  if ( __format == SparseFormat::CSR )
+    multiplyCSRRows( __offsets.data(), __indices.data(), __values.data(),
+                     dense.begin(), result.begin(), dense.cols(), 0, __rows );
+  else
+    multiplyCSC( __offsets.data(), __indices.data(), __values.data(),
+                 dense.begin(), result.begin(), dense.cols(), __cols );
+
+  return result;
+}
+
+/* Multithreaded SpMV / SpMM. Rows are split into contiguous blocks holding roughly equal numbers of non-zeros
+ * (found by binary search on the row offsets), so skewed rows do not leave threads idle. Every thread writes
+ * only to its own block of result rows, so no synchronization is needed besides the final join.
+ * A CSC matrix is first converted to CSR, since scattering columns from several threads would race on the result.
+ * Falls back to the single-threaded overload for a single thread or very small matrices.
+ */
+template<typename _NumericType>
+Matrix<_NumericType> SparseMatrix<_NumericType>::multiply( const Matrix<_NumericType>& dense, unsigned threads ) const
+{
+  if ( __format == SparseFormat::CSC )
+    return toCSR().multiply( dense, threads );
+
+  if ( __cols != dense.rows() )
+    throw std::invalid_argument { "error: dimensions of multiplicand matrices are incompatible for multiplication.\n" };
+
+  if ( threads == 0 )
+    threads = std::max( 1U, std::thread::hardware_concurrency() );
+  threads = static_cast<unsigned>(std::min<size_t>( threads, __rows ));
+  if ( threads <= 1 || nonZeros() * dense.cols() < (1ULL << 14) )
+    return *this * dense;
+
+  Matrix<_NumericType> result { __rows, dense.cols() };
+  std::vector<std::thread> workers;
+  workers.reserve( threads );
+  size_t rowBegin { 0ULL };
+  for ( unsigned t { 1U }; t <= threads; ++t )
+  {
+    // last row whose starting offset does not exceed this thread's share of the non-zeros
+    const size_t share { nonZeros() * t / threads };
+    const size_t rowEnd { t == threads
+      ? __rows
+      : static_cast<size_t>(std::upper_bound( __offsets.begin(), __offsets.end(), share ) - __offsets.begin()) - 1 };
+    if ( rowEnd > rowBegin )
+      workers.emplace_back( multiplyCSRRows<_NumericType>, __offsets.data(), __indices.data(), __values.data(),
+                            dense.begin(), result.begin(), dense.cols(), rowBegin, rowEnd );
+    rowBegin = std::max( rowBegin, rowEnd );
+  }
+  for ( auto& worker : workers )
+    worker.join();
+
+  return result;
+}
+
+/* Prints the stored elements, one per line, in storage order.
+ * Time complexity ~ O(nnz).
+ */
+template<typename _NumericType>
+void SparseMatrix<_NumericType>::view() const
+{
+  for ( size_t i { 0ULL }; i < __major(); ++i )
+    for ( size_t k { __offsets[i] }; k < __offsets[i + 1]; ++k )
+      if ( __format == SparseFormat::CSR )
+        std::cout << '(' << i << ", " << __indices[k] << ") " << __values[k] << '\n';
+      else
+        std::cout << '(' << __indices[k] << ", " << i << ") " << __values[k] << '\n';
+  std::cout << '\n';
+}
+
+// Template instantiations for the distinct standard arithmetic types. The `std::int_fastN_t` aliases are not used :
+// they may name the same type (all 3 are `long` with GCC on Linux), which would instantiate it twice.
+template class SparseMatrix<short>;
+template class SparseMatrix<int>;
+template class SparseMatrix<long>;
+template class SparseMatrix<long long>;
+template class SparseMatrix<float>;
+template class SparseMatrix<double>;
+template class SparseMatrix<long double>;
+
+
+/* Demo of construction and conversion, followed by a benchmark of sparse against dense multiplication.
+ * For each density, a random (N x N) matrix is multiplied with a dense (N x N) matrix and a dense (N x 1) vector.
+ * Times are the best of a few runs in milliseconds, and the largest deviation from the dense result is reported.
+ */
+void testSparseMatrix()
+{
+  const SparseMatrix<double> S { 4, 5, {
+    { 3, 4, 2.0 }, { 0, 1, 1.0 }, { 2, 0, -3.0 }, { 0, 1, 0.5 }, { 1, 3, 7.0 }
+  } };
+  S.view();                               // testing COO construction (duplicates summed)
+  S.toCSC().view();                       // testing conversion to column-major order
+  S.toDense().view();                     // testing expansion into a dense matrix
+
+  auto bestOf = [] ( const int runs, auto&& operation )
+  {
+    double best { std::numeric_limits<double>::max() };
+    for ( int run { 0 }; run < runs; ++run )
+    {
+      const auto start { std::chrono::steady_clock::now() };
+      operation();
+      const std::chrono::duration<double, std::milli> elapsed { std::chrono::steady_clock::now() - start };
+      best = std::min( best, elapsed.count() );
+    }
+    return best;
+  };
+
+  auto maxDeviation = [] ( const Matrix<double>& a, const Matrix<double>& b )
+  {
+    double deviation { 0.0 };
+    for ( auto x { a.begin() }, y { b.begin() }; x != a.end(); ++x, ++y )
+      deviation = std::max( deviation, std::abs( *x - *y ) );
+    return deviation;
+  };
+
+  constexpr size_t N { 512 };
+  std::mt19937 generator { 2021 };
+  std::uniform_real_distribution<double> element { -1.0, 1.0 };
+
+  Matrix<double> B { N, N };
+  Matrix<double> x { N, 1 };
+  for ( auto& el : B ) el = element( generator );
+  for ( auto& el : x ) el = element( generator );
+
+  std::cout << "N = " << N << ", times in ms\n"
+    << std::setw( 10 ) << "density" << std::setw( 12 ) << "dense A*B" << std::setw( 12 ) << "sparse A*B"
+    << std::setw( 12 ) << "dense A*x" << std::setw( 12 ) << "sparse A*x" << std::setw( 12 ) << "parallel"
+    << std::setw( 12 ) << "deviation" << '\n';
+
+  for ( const double density : { 0.5, 0.2, 0.05, 0.01, 0.001 } )
+  {
+    std::bernoulli_distribution isNonZero { density };
+    Matrix<double> A { N, N };
+    for ( auto& el : A )
+      el = isNonZero( generator ) ? element( generator ) : 0.0;
+    const SparseMatrix<double> sparseA { A };
+
+    // shapes differ from any placeholder, so results are emplaced instead of assigned through `operator=`
+    std::optional<Matrix<double>> denseProduct, sparseProduct, denseVector, sparseVector, parallelVector;
+    const auto denseMM { bestOf( 2, [&] { denseProduct.emplace( A * B ); } ) };
+    const auto sparseMM { bestOf( 2, [&] { sparseProduct.emplace( sparseA * B ); } ) };
+    const auto denseMV { bestOf( 10, [&] { denseVector.emplace( A * x ); } ) };
+    const auto sparseMV { bestOf( 10, [&] { sparseVector.emplace( sparseA * x ); } ) };
+    const auto parallelMV { bestOf( 10, [&] { parallelVector.emplace( sparseA.multiply( x ) ); } ) };
+
+    std::cout << std::setw( 10 ) << density << std::fixed << std::setprecision( 3 )
+      << std::setw( 12 ) << denseMM << std::setw( 12 ) << sparseMM
+      << std::setw( 12 ) << denseMV << std::setw( 12 ) << sparseMV << std::setw( 12 ) << parallelMV
+      << std::scientific << std::setprecision( 1 ) << std::setw( 12 )
+      << std::max( { maxDeviation( *denseProduct, *sparseProduct ), maxDeviation( *denseVector, *sparseVector ),
+                     maxDeviation( *denseVector, *parallelVector ) } )
+      << std::defaultfloat << '\n';
+  }
+}
\ No newline at end of file
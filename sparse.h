@@ -0,0 +1,74 @@
+#ifndef __sparse_h__
+#define __sparse_h__
+
+#include "structs.h"        // Matrix
+
+#include <cstddef>          // std::size_t
+#include <vector>           // std::vector
+
+using size_t = std::size_t;
+
+// storage order of the compressed arrays, row-major (CSR) or column-major (CSC)
+enum class SparseFormat
+{
+  CSR,
+  CSC
+};
+
+// a single (row, column, value) entry, used to build a sparse matrix from coordinate (COO) form
+template<typename _NumericType>
+struct Triplet
+{
+  size_t row;
+  size_t col;
+  _NumericType value;
+};
+
+/*/////////////////////////////// Compressed Sparse Matrix (CSR / CSC), interoperating with Matrix ///////////////////////////////
+ *
+ * Only the non-zero elements are stored, in 3 flat arrays. For CSR, `__offsets[r]` .. `__offsets[r + 1]` is the
+ * range of `__indices` (column of each element) and `__values` that belong to row `r`. CSC is the same layout with
+ * the roles of rows and columns swapped. Within every row (column), the indices are kept sorted and unique.
+ * Memory and multiplication cost are proportional to the number of non-zeros instead of rows*cols, which is
+ * what makes this worthwhile for matrices that are mostly zeros.
+ * Products with a dense `Matrix` always return a dense `Matrix`; a dense vector is simply an (n x 1) `Matrix`.
+ */
+template<typename _NumericType>
+class SparseMatrix
+{
+  SparseFormat __format;                                  // storage order of the compressed arrays
+  size_t __rows;                                          // number of rows in the matrix
+  size_t __cols;                                          // number of columns in the matrix
+  std::vector<size_t> __offsets;                          // start of every row (CSR) or column (CSC), plus the end
+  std::vector<size_t> __indices;                          // column (CSR) or row (CSC) of every stored element
+  std::vector<_NumericType> __values;                     // the stored non-zero elements
+
+  SparseMatrix( const size_t rows, const size_t cols, const SparseFormat format );  // empty matrix, used internally
+  size_t __major() const;                                 // number of compressed rows (CSR) or columns (CSC)
+
+public:
+
+  explicit SparseMatrix( const Matrix<_NumericType>& dense,
+                         const SparseFormat format = SparseFormat::CSR );   // compresses the non-zeros of a dense matrix
+  SparseMatrix( const size_t rows, const size_t cols,
+                const std::vector<Triplet<_NumericType>>& triplets,
+                const SparseFormat format = SparseFormat::CSR );          // builds from COO triplets, summing duplicates
+  size_t rows() const;                                    // returns the number of rows
+  size_t cols() const;                                    // returns the number of columns
+  size_t nonZeros() const;                                // returns the number of stored elements
+  SparseFormat format() const;                            // returns the storage order
+
+  SparseMatrix toCSR() const;                             // returns a row-major compressed copy
+  SparseMatrix toCSC() const;                             // returns a column-major compressed copy
+  Matrix<_NumericType> toDense() const;                   // expands back into a dense matrix
+
+  Matrix<_NumericType> operator*( const Matrix<_NumericType>& dense ) const;          // SpMV / SpMM with a dense matrix
+  Matrix<_NumericType> multiply( const Matrix<_NumericType>& dense,
+                                 unsigned threads = 0 ) const;    // multithreaded SpMV / SpMM, 0 = hardware concurrency
+
+  void view() const;                                      // prints the stored elements as (row, col) value
+};
+
+void testSparseMatrix();                                  // demo and benchmark against dense multiplication
+
+#endif
\ No newline at end of file
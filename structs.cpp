@@ -1,328 +1,24 @@
 // Implementations of data structures described in `structs.h`
 
 #include "structs.h"
+#include "parallel.h"       // ThreadPool
 
-#include <algorithm>        // std::copy
+#include <algorithm>        // std::copy, std::equal, std::fill, std::max, std::min
+#include <chrono>           // std::chrono::steady_clock, std::chrono::duration
 #include <cstdint>          // std::int_fast16_t, std::int_fast32_t, std::int_fast64_t
-#include <cstdlib>          // std::abs, std::srand, std::rand
+#include <cstdlib>          // std::srand, std::rand
 #include <ctime>            // std::time
+#include <execution>        // std::execution::seq, std::execution::par
+#include <iomanip>          // std::setw
 #include <iostream>         // std::cin, std::cout
+#include <limits>           // std::numeric_limits
+#include <numeric>          // std::accumulate
 #include <stdexcept>        // std::invalid_argument, std::out_of_range
-#include <utility>          // std::move
-
-//////////////////////////////////// 2D Flat Rectangular Array //////////////////////////////////////
-
-////////// Matrix::Row //////////
-
-// Basic constructor.
-template<typename _NumericType>
-Matrix<_NumericType>::Row::Row( _NumericType* const row, const size_t cols ) :
-  __row { row },
-  __cols { cols }
-{}
-
-// Returns value by indexing the input column in current Row object.
-template<typename _NumericType>
-_NumericType& Matrix<_NumericType>::Row::operator[]( const size_t col ) const
-{
-  if ( col >= __cols )
-    throw std::out_of_range { "error: column index out of bounds.\n" };
-
-  return *(__row + col);
-}
-
-////////// Matrix //////////
-
-// Basic constructor.
-template<typename _NumericType>
-Matrix<_NumericType>::Matrix( const size_t rows, const size_t cols ) :
-  __rows { rows },
-  __cols { cols },
-  __data { (rows * cols) ? std::make_unique<_NumericType[]>( rows * cols ) : nullptr }
-{
-  if ( !__data ) throw std::invalid_argument { "error: matrix has either 0 rows or 0 columns or both.\n" };
-}
-
-/* This constructor accepts the dimensions of the matrix and an initializer list to fill in.
- * It checks if the initializer list shape exceeds that of the matrix to throw an error.
- * In case of list being smaller than the matrix, the remaining values are left zero-initialized.
- */
-template<typename _NumericType>
-Matrix<_NumericType>::Matrix( const size_t rows, const size_t cols, InitializerList2D list ) :
-  Matrix { rows, cols }
-{
-  if ( rows < list.size() )
-    throw std::invalid_argument { "error: too many rows to unpack into Matrix.\n" };
-
-  auto row_begin { __data.get() };
-  for ( auto innerlist : list )
-  {
-    if ( cols < innerlist.size() )
-      throw std::invalid_argument { "error: too many columns to unpack into Matrix.\n" };
-
-    std::copy( innerlist.begin(), innerlist.end(), row_begin );
-    row_begin += cols;
-  }
-}
-
-/* Custom copy constructor, called whenever object is passed by value.
- * Default copy constructor would copy the pointers directly.
- * So when the copy goes out of scope, its destructor will (wrongly) delete the pointers allocated by original object.
- * Later, when the original goes out of scope, its destructor will try to delete the dangling pointer and crash.
- * This constructor creates a deep copy to prevent the above issue, i.e copy has distinct pointers.
- * Time complexity ~ O(n^2) or O(rows*cols).
- */
-template<typename _NumericType>
-Matrix<_NumericType>::Matrix( const Matrix& copy ) :
-  Matrix { copy.__rows, copy.__cols }
-{
-  // copying only the data pointed by original's pointer to copy's distinct pointer
-  std::copy( copy.begin(), copy.end(), this->begin() );
-}
-
-/* Custom move constructor, called whenever an Matrix R-value is used to initiate an Matrix object.
- * Its purpose is the same as the copy constructor, but it is faster than a copy constructor initialized by an
- * Matrix R-value because it directly takes ownership of all assets of Matrix parameter, leaving it in an
- * effectively "useless state". Whereas, copy constructor does not affect data owned by the Matrix parameter and
- * copies all the data to the current object.
- * Time complexity ~ O(1).
- */
-template<typename _NumericType>
-Matrix<_NumericType>::Matrix( Matrix&& temp ) noexcept :
-  __rows { temp.__rows },
-  __cols { temp.__cols },
-  __data { std::move( temp.__data ) }             // "stealing" temp's array into the object being constructed
-{ }
-
-// Returns the value of rows attribute.
-template<typename _NumericType>
-inline
-const size_t Matrix<_NumericType>::rows() const { return __rows; }
-
-// Returns the value of columns attribute.
-template<typename _NumericType>
-inline
-const size_t Matrix<_NumericType>::cols() const { return __cols; }
-
-/* Returns a non-const iterator to the start of the array so that the loop variable inside a range-based `for` loop
- * has the option to be modifiable or read-only, depending on the type of the iterator.
- * for (auto x : Arr) - elements of Arr are read-only.
- * for (auto& x : Arr) - elements of Arr are referenced and modified directly.
- */
-template<typename _NumericType>
-inline
-_NumericType* Matrix<_NumericType>::begin() const { return __data.get(); }
-
-// Returns a const iterator to the end of the array, since it is used only for bound-checking.
-template<typename _NumericType>
-inline
-_NumericType* const Matrix<_NumericType>::end() const { return __data.get() + __rows * __cols; }
-
-/* This function is called for the first index (rows) of the array.
- * It returns a `Row` object, which calls the subscript method for the second index (columns).
- */
-template<typename _NumericType>
-typename Matrix<_NumericType>::Row Matrix<_NumericType>::operator[]( const size_t row ) const
-{
-  if ( row >= __rows )
-    throw std::out_of_range { "error: row index out of bounds.\n" };
-
-  return Row { __data.get() + row * __cols, __cols };
-}
-
-/* Copy assignment operator for Matrix.
- * Rows and columns of LHS and RHS are expected to be equal before assignment.
- * All the data pointed by RHS pointer is copied to LHS pointer.
- * Pointers themselves are not copied to avoid multiple references to same data.
- * Time complexity ~ O(n^2) or O(rows*cols).
- */
- //template<typename _NumericType>
- //void Matrix<_NumericType>::operator=( const Matrix& copy )
- //{
- //  if ( this->__rows != copy.__rows || this->__cols != copy.__cols )
- //    throw std::invalid_argument { "error: source and target matrix dimensions do not match.\n" };
- //
- //  std::copy( copy.begin(), copy.end(), this->begin() );
- //}
-
- /* Move assignment operator for Matrix.
-  * Rows and columns of LHS and RHS are expected to be equal before assignment.
-  * Pointers are swapped with the temporary object, since it is destroyed at end of this function.
-  * Time complexity ~ O(1).
-  */
-  //template<typename _NumericType>
-  //void Matrix<_NumericType>::operator=( Matrix&& temp ) noexcept
-  //{
-  //  if ( this->__rows != temp.__rows || this->__cols != temp.__cols )
-  //    throw std::invalid_argument { "error: source and target matrix dimensions do not match.\n" };
-  //
-  //  __data = std::move( temp.__data );
-  //}
-
-  /* Copy-and-Swap idiom (both Move and Copy assignment)
-  /// If this operator is uncommented, comment both copy and move assignment operator overloads above; they will be unnecessary. ///
-  /// This implementation is better in the general case of assigning (replacing) Matrix objects even if they have different sizes. ///
-  /// Utilizes the respective constructor to make the necessary argument object, removing any possibility of bugs in this operator. ///
-   * If an r-value Matrix is passed as an argument, then argument `mat` will be constructed using the move constructor from an r-value.
-   * If an l-value Matrix is passed as an argument, then argument `mat` will be constructed using the copy constructor from an l-value.
-   * Time complexity depends on the type of constructor used for argument `mat`.
-   * Time complexity ~ O(1) [move constructed] OR O(n^2) [copy constructed]
-   */
-template<typename _NumericType>
-void Matrix<_NumericType>::operator=( Matrix mat )
-{
-  if ( this->__rows != mat.__rows || this->__cols != mat.__cols )
-    throw std::invalid_argument { "error: source and target matrix dimensions do not match.\n" };
-
-  __data = std::move( mat.__data );
-}
-
-// Overload for unary positive operator. Constant time complexity.
-template<typename _NumericType>
-Matrix<_NumericType> Matrix<_NumericType>::operator+() const { return *this; }
-
-/* Overload for adding 2 matrices of same dimensions.
- * Rows and columns of LHS and RHS are expected to be equal before addition.
- * Time complexity ~ O(n^2) or O(rows*cols).
- */
-template<typename _NumericType>
-Matrix<_NumericType> Matrix<_NumericType>::operator+( const Matrix& other ) const
-{
-  if ( this->__rows != other.__rows || this->__cols != other.__cols )
-    throw std::invalid_argument { "error: dimensions of addend matrices do not match.\n" };
-
-  Matrix result { __rows, __cols };
-  for ( size_t i { 0ULL }; i < __rows * __cols; ++i )
-    result.__data[i] = this->__data[i] + other.__data[i];
-
-  return result;
-}
-
-/* Overload for shorthand addition, straightforward implementation using addition overload.
- * Time complexity is same as addition ~ O(n^2) or O(rows*cols).
- */
-template<typename _NumericType>
-inline
-void Matrix<_NumericType>::operator+=( const Matrix& other ) { *this = *this + other; }
-
-/* Overload for inverting the sign of all elements of a matrix.
- * Time complexity is same as multiplication with a scalar ~ O(n^2) or O(rows*cols).
- */
-template<typename _NumericType>
-inline
-Matrix<_NumericType> Matrix<_NumericType>::operator-() const { return *this * -1; }
-
-/* Overload for subtraction between 2 matrices of same dimensions.
- * Rows and columns of LHS and RHS are expected to be equal before subtraction.
- * Time complexity ~ O(n^2) or O(rows*cols).
- */
-template<typename _NumericType>
-Matrix<_NumericType> Matrix<_NumericType>::operator-( const Matrix& other ) const
-{
-  if ( this->__rows != other.__rows || this->__cols != other.__cols )
-    throw std::invalid_argument { "error: minuend and subtrahend matrix dimensions do not match.\n" };
-
-  Matrix result { __rows, __cols };
-  for ( size_t i { 0ULL }; i < __rows * __cols; ++i )
-    result.__data[i] = this->__data[i] - other.__data[i];
-
-  return result;
-}
-
-/* Overload for shorthand subtraction, straightforward implementation using subtraction overload.
- * Time complexity is same as subtraction ~ O(n^2) or O(rows*cols).
- */
-template<typename _NumericType>
-inline
-void Matrix<_NumericType>::operator-=( const Matrix& other ) { *this = *this - other; }
-
-/* Overload for multiplication of two Matrix objects.
- * Checks the matrix multiplication dimensions prerequisite.
- * Returns the resultant Matrix object.
- * Naive algorithm, time complexity ~ O(n^3) ~ O(rows1*cols1*cols2).
- */
-template<typename _NumericType>
-Matrix<_NumericType> Matrix<_NumericType>::operator*( const Matrix& other ) const
-{
-  if ( this->__cols != other.__rows )
-    throw std::invalid_argument { "error: dimensions of multiplicand matrices are incompatible for multiplication.\n" };
-
-  Matrix result { this->__rows, other.__cols };
-  for ( size_t m { 0ULL }; m < result.__rows; ++m )
-    for ( size_t n { 0ULL }; n < result.__cols; ++n )
-      for ( size_t p { 0ULL }; p < this->__cols; ++p )
-        result.__data[m * __cols + n] += __data[m * __cols + p] * other.__data[p * __cols + n];
-
-  return result;
-}
-
-/* Overload for multiplying every element of matrix with a scalar value.
- * Time complexity ~ O(n^2) or O(rows*cols).
- */
-template<typename _NumericType>
-Matrix<_NumericType> Matrix<_NumericType>::operator*( const _NumericType value ) const
-{
-  Matrix result { __rows, __cols };
-  for ( size_t i { 0ULL }; i < __rows * __cols; ++i )
-    result.__data[i] = this->__data[i] * value;
-
-  return result;
-}
-
-/* Overload for shorthand multiplication, straightforward implementation using multiplication overload.
- * Time complexity is same as multiplication ~ O(n^3) ~ O(rows1*cols1*cols2).
- */
-template<typename _NumericType>
-inline
-void Matrix<_NumericType>::operator*=( const Matrix& other ) { *this = *this * other; }
-
-/* Prints the contents of the array in its given shape.
- * Time complexity ~ O(n^2) or O(rows*cols).
- */
-template<typename _NumericType>
-void Matrix<_NumericType>::view() const
-{
-  for ( size_t row { 0ULL }; row < __rows; ++row )
-  {
-    for ( size_t col { 0ULL }; col < __cols; ++col )
-      std::cout << __data[row * __cols + col] << ' ';
-    std::cout << '\n';
-  }
-  std::cout << '\n';
-}
-
-/* Overload to make scalar matrix multiplication commutative.
- * Implemented using the Matrix class overload.
- * Time complexity ~ O(n^2) or O(rows*cols).
- */
-template<typename _NumericType>
-inline
-Matrix<_NumericType> operator*( const _NumericType value, const Matrix<_NumericType>& mat ) { return mat * value; }
-
-
-/* << IMPORTANT >>
- * "Explicit instantiation" : The template class implementation is stored in a source file, seperately from
- * definitions in the header. This means that only the pre-specified explicit instances of the template can be used, and
- * for every new (user-defined) datatype, we have to manually add an instance before using it.
- * Not doing this will throw a linker error since it can not find the type-specific implementation of the methods it sees
- * in template class. By compiling the explicit instances, the linker will be able to find the desired variation of template.
- *
- * "Header inclusion" : Both the definition and implementation of the class template is stored in the header file.
- * This means that every file that includes the header has full knowledge of how the class functions and therefore knows
- * how to create a template instance for a generic type (including user-defined types).
- * But this also slows down compilation process for significantly large projects because every file including the class
- * template header creates its own required template instances which the linker has to sort through to prevent ODR violation,
- * unlike explicit instantiation which is much faster with pre-defined instances.
- *
- * Below is explicit instantiation method.
- */
-template class Matrix<std::int_fast16_t>;
-template class Matrix<std::int_fast32_t>;
-template class Matrix<std::int_fast64_t>;
-template class Matrix<float>;
-template class Matrix<double>;
-template class Matrix<long double>;
-
+#include <string>           // std::to_string
+#include <thread>           // std::thread
+#include <type_traits>      // std::is_same_v
+#include <utility>          // std::move, std::swap
+#include <vector>           // std::vector
 
 // Simple test function for `Matrix` demo.
 void testArray2d()
@@ -383,68 +79,136 @@ void testArray2d()
 }
 
 
-///////////////////////////////// Python-like Range-based Iterator ///////////////////////////////////
-
-////////// IntRange::Iterator //////////
-
-template<typename _Integer>
-IntRange<_Integer>::Iterator::Iterator( const _Integer value, const _Integer step ) :
-  __value { value },
-  __step { step }
-{ }
-
-/* A hack taking advantage of the internal mechanism of for-each loops.
- * Checking equality `__value` and `other` to terminate the iteration will break down in case of "end" value
- * being a distance of non-exact multiple of step away from "begin" value, for instance `IntRange{10, 200, 30}`.
- * Hence, to account for this, we check if we have already crossed the "end" value, and terminate the iteration.
- * This is done using the direction of `__step` and current `__value` relative to "end" value.
+/* Times one kind of transpose, best of 3 runs, and returns the bandwidth in GB/s.
+ * Every element is read once and written once, so 2 * rows * cols * sizeof(element) bytes are moved per run.
  */
-template<typename _Integer>
-bool IntRange<_Integer>::Iterator::operator!=( const _Integer other )
+template<typename _Operation>
+static double transposeBandwidth( const size_t bytes, _Operation operation )
 {
-  return (other - __value) * __step > 0;
+  double best { std::numeric_limits<double>::max() };
+  for ( int run { 0 }; run < 3; ++run )
+  {
+    const auto start { std::chrono::steady_clock::now() };
+    operation();
+    const std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+    best = std::min( best, elapsed.count() );
+  }
+  return 2.0 * bytes / best / 1e9;
 }
 
-// Indirection should yield the value contained, not the address of wrapper
-template<typename _Integer>
-_Integer IntRange<_Integer>::Iterator::operator*() { return __value; }
-
-// `typename` keyword is necessary for compiler because the name of the return type is dependent on the template
-template<typename _Integer>
-typename IntRange<_Integer>::Iterator& IntRange<_Integer>::Iterator::operator++()
+// Compares the transposes of a random (rows x cols) matrix against a simple double loop.
+template<typename _NumericType>
+static void benchmarkTranspose( const char* const name, const size_t rows, const size_t cols )
 {
-  __value += __step;
-  return *this;
-}
+  Matrix<_NumericType> A { rows, cols };
+  for ( auto& el : A )
+    el = static_cast<_NumericType>(std::rand() % 1000);
 
-////////// IntRange //////////
+  Matrix<_NumericType> naive { cols, rows };
+  const double naiveRate { transposeBandwidth( rows * cols * sizeof( _NumericType ), [&]
+  {
+    const _NumericType* const src { A.begin() };
+    _NumericType* const dst { naive.begin() };
+    for ( size_t i { 0ULL }; i < rows; ++i )
+      for ( size_t j { 0ULL }; j < cols; ++j )
+        dst[j * rows + i] = src[i * cols + j];
+  } ) };
+
+  Matrix<_NumericType> blocked { cols, rows };
+  const double blockedRate { transposeBandwidth( rows * cols * sizeof( _NumericType ), [&] { A.transpose( blocked ); } ) };
+  const double allocatingRate { transposeBandwidth( rows * cols * sizeof( _NumericType ), [&] { blocked = A.transpose(); } ) };
+
+  Matrix<_NumericType> inPlace { A };
+  inPlace.transposeInPlace();
+  const bool correct { std::equal( naive.begin(), naive.end(), blocked.begin() ) &&
+                       std::equal( naive.begin(), naive.end(), inPlace.begin() ) && inPlace.rows() == cols };
+  const double inPlaceRate { transposeBandwidth( rows * cols * sizeof( _NumericType ), [&] { inPlace.transposeInPlace(); } ) };
+
+  std::cout << std::setw( 8 ) << name << std::setw( 7 ) << rows << " x" << std::setw( 6 ) << cols
+    << std::setw( 12 ) << naiveRate << std::setw( 12 ) << blockedRate << std::setw( 12 ) << allocatingRate
+    << std::setw( 12 ) << inPlaceRate
+    << std::setw( 10 ) << (correct ? "ok" : "WRONG") << '\n';
+}
 
-template<typename _Integer>
-IntRange<_Integer>::IntRange( const _Integer begin, const _Integer end, const _Integer step ) :
-  __begin { begin },
-  __end { end },
-  // correctly initializes step value irrespective of sign mismatch by the user
-  __step { (__begin < __end) ? std::abs( step ) : -std::abs( step ) }
-{ }
+/* Reports GB/s of the simple double loop and of the cache-oblivious transpose, both writing into an existing
+ * matrix, then of the transpose returning a newly allocated matrix, and of the in-place transpose.
+ */
+void testTranspose()
+{
+  std::srand( 2021 );
+  std::cout << std::setw( 8 ) << "type" << std::setw( 15 ) << "shape" << std::setw( 12 ) << "loop GB/s"
+    << std::setw( 12 ) << "into" << std::setw( 12 ) << "returning" << std::setw( 12 ) << "in-place" << '\n';
+  for ( const size_t n : { 256, 1024, 4096 } )
+    benchmarkTranspose<float>( "float", n, n );
+  benchmarkTranspose<float>( "float", 3000, 2000 );
+  for ( const size_t n : { 256, 1024, 4096 } )
+    benchmarkTranspose<double>( "double", n, n );
+  benchmarkTranspose<double>( "double", 3000, 2000 );
+  benchmarkTranspose<double>( "double", 1023, 1025 );
+}
 
-template<typename _Integer>
-IntRange<_Integer>::IntRange( const _Integer end ) :
-  IntRange { 0, end, 1 }    // calling the overloaded constructor with all parameters
-{ }
+/* Times every matrix operation with an execution policy under `seq` and `par`, on random square matrices of a few
+ * sizes, and checks that both policies give the same result. Only `par` uses the shared thread pool.
+ */
+void testParallelMatrix()
+{
+  std::srand( 2021 );
+  const auto time { [] ( const auto& operation )
+  {
+    double best { std::numeric_limits<double>::max() };
+    for ( int run { 0 }; run < 3; ++run )
+    {
+      const auto start { std::chrono::steady_clock::now() };
+      operation();
+      const std::chrono::duration<double, std::milli> elapsed { std::chrono::steady_clock::now() - start };
+      best = std::min( best, elapsed.count() );
+    }
+    return best;
+  } };
 
-// `typename` keyword is necessary for compiler because the name of the return type is dependent on the template
-template<typename _Integer>
-typename IntRange<_Integer>::Iterator IntRange<_Integer>::begin() { return Iterator { __begin, __step }; }
+  std::cout << ThreadPool::shared().threads() << " threads\n" << std::setw( 10 ) << "operation" << std::setw( 8 ) << "n"
+    << std::setw( 12 ) << "seq (ms)" << std::setw( 12 ) << "par (ms)" << std::setw( 10 ) << "same" << '\n';
+  for ( const size_t n : { 128, 512, 1024 } )
+  {
+    Matrix<double> a { n, n }, b { n, n };
+    for ( auto& el : a )
+      el = std::rand() % 1000 / 1e3;
+    for ( auto& el : b )
+      el = std::rand() % 1000 / 1e3;
+
+    const auto compare { [&] ( const char* const name, const auto& operation )
+    {
+      Matrix<double> serial { n, n }, parallel { n, n };
+      const double serialTime { time( [&] { serial = operation( std::execution::seq ); } ) };
+      const double parallelTime { time( [&] { parallel = operation( std::execution::par ); } ) };
+      std::cout << std::setw( 10 ) << name << std::setw( 8 ) << n << std::setw( 12 ) << serialTime << std::setw( 12 )
+        << parallelTime << std::setw( 10 ) << std::boolalpha
+        << std::equal( serial.begin(), serial.end(), parallel.begin() ) << '\n';
+    } };
+    compare( "add", [&] ( const auto& policy ) { return a.add( policy, b ); } );
+    compare( "subtract", [&] ( const auto& policy ) { return a.subtract( policy, b ); } );
+    compare( "scale", [&] ( const auto& policy ) { return a.scale( policy, 0.5 ); } );
+    compare( "multiply", [&] ( const auto& policy ) { return a.multiply( policy, b ); } );
+  }
+}
 
-template<typename _Integer>
-const _Integer IntRange<_Integer>::end() { return __end; }
 
-// Template class instantiations for desired datatypes
-template class IntRange<std::int_fast32_t>;
-template class IntRange<std::int_fast64_t>;
+///////////////////////////////// Python-like Range-based Iterator ///////////////////////////////////
 
+// Times `loop()`, repeated `repeats` times, in nanoseconds per repeat.
+template<typename _Loop>
+static double timeLoop( const size_t repeats, _Loop loop )
+{
+  const auto start { std::chrono::steady_clock::now() };
+  for ( size_t r { 0 }; r < repeats; ++r )
+    loop();
+  const std::chrono::duration<double, std::nano> elapsed { std::chrono::steady_clock::now() - start };
+  return elapsed.count() / repeats;
+}
 
-// Simple test function for `IntRange` demo
+/* Demo of `IntRange`, then timings of the same loop bodies over a plain index loop and over a range :
+ * a contiguous saxpy (y = a*x + y), a strided sum, and a sum split across threads by `split`.
+ */
 void testIntRange()
 {
   int count { 0 };
@@ -453,4 +217,87 @@ void testIntRange()
     std::cout << num << '\t';
     if ( ++count % 10 == 0 ) std::cout << '\n';
   }
+  std::cout << '\n';
+
+  for ( const auto& part : IntRange<int> { 10, 200, 30 }.split( 3 ) )
+  {
+    std::cout << "[ ";
+    for ( const auto num : part )
+      std::cout << num << ' ';
+    std::cout << "] ";
+  }
+  std::cout << '\n';
+
+  using Index = std::int_fast64_t;
+  constexpr size_t n { 1 << 16 };                         // 2 float arrays of 256 KiB, in L2
+  constexpr size_t repeats { 2'000 };
+  std::vector<float> x( n, 1.5f ), y( n, 0.5f );
+  std::vector<std::int32_t> values( n );
+  for ( size_t i { 0 }; i < n; ++i )
+    values[i] = static_cast<std::int32_t>(i % 1'000);
+
+  std::cout << std::setw( 22 ) << "loop" << std::setw( 16 ) << "index (ns)" << std::setw( 16 ) << "IntRange (ns)" << '\n';
+
+  const double rawSaxpy { timeLoop( repeats, [&]
+  {
+    for ( size_t i { 0 }; i < n; ++i )
+      y[i] = 0.5f * x[i] + y[i];
+  } ) };
+  const double rangeSaxpy { timeLoop( repeats, [&]
+  {
+    for ( const Index i : IntRange<Index> { static_cast<Index>(n) } )
+      y[i] = 0.5f * x[i] + y[i];
+  } ) };
+  std::cout << std::setw( 22 ) << "saxpy" << std::setw( 16 ) << rawSaxpy << std::setw( 16 ) << rangeSaxpy << '\n';
+
+  std::int64_t rawSum { 0 }, rangeSum { 0 };
+  const double rawStrided { timeLoop( repeats, [&]
+  {
+    for ( size_t i { 1 }; i < n; i += 3 )
+      rawSum += values[i];
+  } ) };
+  const double rangeStrided { timeLoop( repeats, [&]
+  {
+    for ( const Index i : IntRange<Index> { 1, static_cast<Index>(n), 3 } )
+      rangeSum += values[i];
+  } ) };
+  std::cout << std::setw( 22 ) << "strided sum" << std::setw( 16 ) << rawStrided << std::setw( 16 ) << rangeStrided
+    << (rawSum == rangeSum ? "" : "  MISMATCH") << '\n';
+
+  // each thread sums its own subrange; the index loop splits the same way by hand
+  const unsigned threads { std::max( 1U, std::thread::hardware_concurrency() ) };
+  std::vector<std::int64_t> partial( threads );
+  const double rawSplit { timeLoop( repeats / 10, [&]
+  {
+    std::vector<std::thread> workers;
+    for ( unsigned t { 0U }; t < threads; ++t )
+      workers.emplace_back( [&, t]
+      {
+        std::int64_t sum { 0 };
+        for ( size_t i { n * t / threads }; i < n * (t + 1) / threads; ++i )
+          sum += values[i];
+        partial[t] = sum;
+      } );
+    for ( auto& worker : workers )
+      worker.join();
+  } ) };
+  const std::int64_t rawTotal { std::accumulate( partial.begin(), partial.end(), std::int64_t { 0 } ) };
+  const double rangeSplit { timeLoop( repeats / 10, [&]
+  {
+    const std::vector<IntRange<Index>> parts { IntRange<Index> { static_cast<Index>(n) }.split( threads ) };
+    std::vector<std::thread> workers;
+    for ( size_t t { 0 }; t < parts.size(); ++t )
+      workers.emplace_back( [&, t]
+      {
+        std::int64_t sum { 0 };
+        for ( const Index i : parts[t] )
+          sum += values[i];
+        partial[t] = sum;
+      } );
+    for ( auto& worker : workers )
+      worker.join();
+  } ) };
+  const std::int64_t rangeTotal { std::accumulate( partial.begin(), partial.end(), std::int64_t { 0 } ) };
+  std::cout << std::setw( 22 ) << std::to_string( threads ) + " thread sum" << std::setw( 16 ) << rawSplit
+    << std::setw( 16 ) << rangeSplit << (rawTotal == rangeTotal ? "" : "  MISMATCH") << '\n';
 }
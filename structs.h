@@ -1,9 +1,29 @@
 #ifndef __structs_h__
 #define __structs_h__
 
-#include <cstddef>          // std::size_t
+#include "policy.h"         // EnableIfExecutionPolicy, isParallelPolicy, parallelBlocks
+#include "pool.h"           // PoolArray, pool_make_array
+#include "trace.h"          // TRACE_SCOPE, TRACE_MOVED
+
+#include <algorithm>        // std::copy, std::fill, std::max, std::min, std::swap
+#include <cstddef>          // std::size_t, std::ptrdiff_t
+#include <cstdint>          // std::uint64_t
+#include <execution>        // std::execution::seq, std::execution::sequenced_policy
 #include <initializer_list> // std::initializer_list
-#include <memory>           // std::make_unique, std::unique_ptr
+#include <iostream>         // std::cout
+#include <iterator>         // std::random_access_iterator_tag
+#include <limits>           // std::numeric_limits
+#include <memory>           // std::unique_ptr
+#include <stdexcept>        // std::invalid_argument, std::length_error
+#include <type_traits>      // std::is_integral_v, std::is_same_v, std::is_signed_v, std::make_unsigned_t
+#include <utility>          // std::move, std::swap
+#include <vector>           // std::vector
+
+// SSE2 is always available on x64, AVX only when the compiler is allowed to use it (/arch:AVX, -mavx)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATRIX_USE_SSE2
+#include <immintrin.h>      // _mm_loadu_ps, _MM_TRANSPOSE4_PS, _mm_unpacklo_pd, _mm256_permute2f128_pd, ...
+#endif
 
 using size_t = std::size_t;
 
@@ -14,6 +34,8 @@ using size_t = std::size_t;
  * to hold the entire array.
  * Subscript operator is then overloaded to index into the 1D memory chunk using the traditional 2D
  * subscripts [][]. Support is provided for the range-based for loop iteration as well.
+ * The chunk comes from the pool of pool.h : inside a `PoolScope`, the results of arithmetic reuse the memory of
+ * earlier temporaries instead of allocating from the heap.
  */
 template<typename _NumericType>
 class Matrix
@@ -38,9 +60,16 @@ class Matrix
     _NumericType& operator[]( const size_t col ) const;   // bounds check and returns reference to desired element
   };
 
-  const size_t __rows;                                    // number of rows in the 2d array
-  const size_t __cols;                                    // number of columns in the 2d array
-  std::unique_ptr<_NumericType[]> __data;                 // the actual data stored in the 2d array
+  size_t __rows;                                          // number of rows in the 2d array (swapped by in-place transpose)
+  size_t __cols;                                          // number of columns in the 2d array (swapped by in-place transpose)
+  PoolArray<_NumericType> __data;                         // the actual data stored in the 2d array, see pool.h
+
+  template<typename _ExecutionPolicy = std::execution::sequenced_policy>
+  static void __multiplyInto( const _NumericType* lhs, const _NumericType* rhs, _NumericType* out,
+                              const size_t m, const size_t k, const size_t n );   // (m x k) * (k x n) into `out`
+  template<typename _ExecutionPolicy, typename _Block>
+  static void __forBlocks( const size_t count, const size_t grain,
+                           const _Block& block );         // runs `block( first, last )` over [0, count) under the policy
 
 public:
 
@@ -69,6 +98,21 @@ public:
   Matrix operator*( const _NumericType value ) const;     // multiply scalar to every element of the matrix
   void operator*=( const Matrix& other );                 // overloading shorthand operator (multiplication)
 
+  // the same operations under a standard execution policy (policy.h), `par` spreads them over `ThreadPool::shared()`
+  template<typename _ExecutionPolicy, typename = EnableIfExecutionPolicy<_ExecutionPolicy>>
+  Matrix add( _ExecutionPolicy&& policy, const Matrix& other ) const;
+  template<typename _ExecutionPolicy, typename = EnableIfExecutionPolicy<_ExecutionPolicy>>
+  Matrix subtract( _ExecutionPolicy&& policy, const Matrix& other ) const;
+  template<typename _ExecutionPolicy, typename = EnableIfExecutionPolicy<_ExecutionPolicy>>
+  Matrix multiply( _ExecutionPolicy&& policy, const Matrix& other ) const;
+  template<typename _ExecutionPolicy, typename = EnableIfExecutionPolicy<_ExecutionPolicy>>
+  Matrix scale( _ExecutionPolicy&& policy, const _NumericType value ) const;
+
+  Matrix pow( std::uint64_t exp ) const;                  // raise a square matrix to a power, reusing scratch buffers
+  Matrix transpose() const;                               // returns the transposed matrix, cache-oblivious
+  void transpose( Matrix& result ) const;                 // writes the transpose into an existing (cols x rows) matrix
+  void transposeInPlace();                                // transposes without a second array, swapping the dimensions
+
   void view() const;                                      // prints the contents of the array
 };
 
@@ -76,49 +120,972 @@ public:
 template<typename _NumericType>
 Matrix<_NumericType> operator*( const _NumericType value, const Matrix<_NumericType>& mat );
 
+/* Block multiply-accumulate, C += alpha * A * B, for row-major (m x k), (k x n) and (m x n) blocks that may be parts of
+ * larger arrays: consecutive rows of A, B and C are `lda`, `ldb` and `ldc` elements apart.
+ * This is the kernel behind `Matrix` multiplication, exposed so that algorithms working on sub-blocks in place
+ * (such as the blocked LU decomposition in linalg.h) use the same fast path. C must not overlap A or B.
+ * Time complexity ~ O(m*k*n).
+ */
+template<typename _NumericType>
+void multiplyAccumulate( const _NumericType* a, const size_t lda, const _NumericType* b, const size_t ldb,
+                         _NumericType* c, const size_t ldc, const size_t m, const size_t k, const size_t n,
+                         const _NumericType alpha = _NumericType { 1 } );
+
 void testArray2d();                                       // demo function
+void testTranspose();                                     // benchmark of the transposes against a simple double loop
+void testParallelMatrix();                                 // times the matrix operations under `seq` and `par`
+
+/*///////////////////////////////////////// Matrix implementation /////////////////////////////////////////
+ *
+ * << IMPORTANT >>
+ * "Explicit instantiation" : The template class implementation is stored in a source file, seperately from
+ * definitions in the header. This means that only the pre-specified explicit instances of the template can be used, and
+ * for every new (user-defined) datatype, we have to manually add an instance before using it.
+ * Not doing this will throw a linker error since it can not find the type-specific implementation of the methods it sees
+ * in template class. By compiling the explicit instances, the linker will be able to find the desired variation of template.
+ *
+ * "Header inclusion" : Both the definition and implementation of the class template is stored in the header file.
+ * This means that every file that includes the header has full knowledge of how the class functions and therefore knows
+ * how to create a template instance for a generic type (including user-defined types).
+ * But this also slows down compilation process for significantly large projects because every file including the class
+ * template header creates its own required template instances which the linker has to sort through to prevent ODR violation,
+ * unlike explicit instantiation which is much faster with pre-defined instances.
+ *
+ * `Matrix` used explicit instantiation, for 6 element types. It now uses header inclusion : any element type works,
+ * and the small members and kernels below can be inlined and optimized together with the code calling them.
+ * `SparseMatrix`, `MatrixBatch` and the file functions of matrixio.h keep explicit instantiation. They are instantiated
+ * for the 7 distinct standard arithmetic types (short to long double), not the `std::int_fastN_t` aliases. Those
+ * aliases may all name one type (`long` with GCC on Linux), and instantiating it twice does not compile.
+ */
+
+////////// Matrix::Row //////////
+
+// Basic constructor.
+template<typename _NumericType>
+Matrix<_NumericType>::Row::Row( _NumericType* const row, const size_t cols ) :
+  __cols { cols },
+  __row { row }
+{}
+
+// Returns value by indexing the input column in current Row object.
+template<typename _NumericType>
+_NumericType& Matrix<_NumericType>::Row::operator[]( const size_t col ) const
+{
+  if ( col >= __cols )
+    throw std::out_of_range { "error: column index out of bounds.\n" };
+
+  return *(__row + col);
+}
+
+////////// Transposition kernels //////////
+
+/* Side length of the square tile that `microTranspose` transposes entirely in SIMD registers.
+ * 4x4 floats fit in 4 SSE registers, 4x4 doubles in 4 AVX registers (2x2 with only SSE2).
+ * Types without a SIMD kernel use 1x1 "tiles", i.e plain element copies.
+ */
+template<typename _NumericType>
+constexpr size_t microTileSize()
+{
+#ifdef MATRIX_USE_SSE2
+  if constexpr ( std::is_same_v<_NumericType, float> )
+    return 4;
+  else if constexpr ( std::is_same_v<_NumericType, double> )
+#ifdef __AVX__
+    return 4;
+#else
+    return 2;
+#endif
+  else
+    return 1;
+#else
+  return 1;
+#endif
+}
+
+/* Transposes one tile of `microTileSize` x `microTileSize` elements from `src` into `dst`.
+ * Rows of the tile are loaded into registers, shuffled into columns, and stored as rows of `dst`,
+ * so each element is read and written exactly once, with full-width loads and stores.
+ */
+template<typename _NumericType>
+inline void microTranspose( const _NumericType* const src, const size_t srcStride,
+                            _NumericType* const dst, const size_t dstStride )
+{
+#ifdef MATRIX_USE_SSE2
+  if constexpr ( std::is_same_v<_NumericType, float> )
+  {
+    __m128 row0 { _mm_loadu_ps( src ) };
+    __m128 row1 { _mm_loadu_ps( src + srcStride ) };
+    __m128 row2 { _mm_loadu_ps( src + 2 * srcStride ) };
+    __m128 row3 { _mm_loadu_ps( src + 3 * srcStride ) };
+    _MM_TRANSPOSE4_PS( row0, row1, row2, row3 );
+    _mm_storeu_ps( dst, row0 );
+    _mm_storeu_ps( dst + dstStride, row1 );
+    _mm_storeu_ps( dst + 2 * dstStride, row2 );
+    _mm_storeu_ps( dst + 3 * dstStride, row3 );
+    return;
+  }
+  else if constexpr ( std::is_same_v<_NumericType, double> )
+  {
+#ifdef __AVX__
+    const __m256d row0 { _mm256_loadu_pd( src ) };
+    const __m256d row1 { _mm256_loadu_pd( src + srcStride ) };
+    const __m256d row2 { _mm256_loadu_pd( src + 2 * srcStride ) };
+    const __m256d row3 { _mm256_loadu_pd( src + 3 * srcStride ) };
+    const __m256d even01 { _mm256_unpacklo_pd( row0, row1 ) };  // r0[0] r1[0] r0[2] r1[2]
+    const __m256d odd01 { _mm256_unpackhi_pd( row0, row1 ) };   // r0[1] r1[1] r0[3] r1[3]
+    const __m256d even23 { _mm256_unpacklo_pd( row2, row3 ) };
+    const __m256d odd23 { _mm256_unpackhi_pd( row2, row3 ) };
+    _mm256_storeu_pd( dst, _mm256_permute2f128_pd( even01, even23, 0x20 ) );
+    _mm256_storeu_pd( dst + dstStride, _mm256_permute2f128_pd( odd01, odd23, 0x20 ) );
+    _mm256_storeu_pd( dst + 2 * dstStride, _mm256_permute2f128_pd( even01, even23, 0x31 ) );
+    _mm256_storeu_pd( dst + 3 * dstStride, _mm256_permute2f128_pd( odd01, odd23, 0x31 ) );
+#else
+    const __m128d row0 { _mm_loadu_pd( src ) };
+    const __m128d row1 { _mm_loadu_pd( src + srcStride ) };
+    _mm_storeu_pd( dst, _mm_unpacklo_pd( row0, row1 ) );
+    _mm_storeu_pd( dst + dstStride, _mm_unpackhi_pd( row0, row1 ) );
+#endif
+    return;
+  }
+#endif
+  (void)srcStride;
+  (void)dstStride;
+  *dst = *src;
+}
+
+/* Transposes a block of `rows` x `cols` elements that fits in L1 cache, tile by tile.
+ * Elements left over at the right and bottom edges (less than one tile) are copied one at a time.
+ */
+template<typename _NumericType>
+inline void transposeBlock( const _NumericType* const src, const size_t srcStride,
+                            _NumericType* const dst, const size_t dstStride, const size_t rows, const size_t cols )
+{
+  constexpr size_t tile { microTileSize<_NumericType>() };
+  const size_t fullRows { rows - rows % tile };
+  const size_t fullCols { cols - cols % tile };
+
+  for ( size_t i { 0ULL }; i < fullRows; i += tile )
+    for ( size_t j { 0ULL }; j < fullCols; j += tile )
+      microTranspose( src + i * srcStride + j, srcStride, dst + j * dstStride + i, dstStride );
+
+  for ( size_t i { 0ULL }; i < rows; ++i )
+    for ( size_t j { fullCols }; j < cols; ++j )
+      dst[j * dstStride + i] = src[i * srcStride + j];
+  for ( size_t i { fullRows }; i < rows; ++i )
+    for ( size_t j { 0ULL }; j < fullCols; ++j )
+      dst[j * dstStride + i] = src[i * srcStride + j];
+}
+
+/* Cache-oblivious out-of-place transpose. The longer side of the block is halved until the block is small
+ * enough for `transposeBlock`. Whatever the cache sizes are, at some level of the recursion the source and
+ * destination blocks both fit in cache, so every cache line is loaded about once instead of once per element,
+ * which is what happens to the writes (or reads) of a simple double loop over a large matrix.
+ * Split points are rounded to whole tiles, so that the SIMD kernel covers as much of the matrix as possible.
+ */
+template<typename _NumericType>
+inline void transposeRecursive( const _NumericType* const src, const size_t srcStride,
+                                _NumericType* const dst, const size_t dstStride, const size_t rows, const size_t cols )
+{
+  constexpr size_t tile { microTileSize<_NumericType>() };
+  constexpr size_t blockElements { 32 * 32 };
+
+  if ( rows * cols <= blockElements || (rows <= tile && cols <= tile) )
+    transposeBlock( src, srcStride, dst, dstStride, rows, cols );
+  else if ( rows >= cols )
+  {
+    const size_t half { (rows / 2 + tile - 1) / tile * tile };
+    transposeRecursive( src, srcStride, dst, dstStride, half, cols );
+    transposeRecursive( src + half * srcStride, srcStride, dst + half, dstStride, rows - half, cols );
+  }
+  else
+  {
+    const size_t half { (cols / 2 + tile - 1) / tile * tile };
+    transposeRecursive( src, srcStride, dst, dstStride, rows, half );
+    transposeRecursive( src + half, srcStride, dst + half * dstStride, dstStride, rows, cols - half );
+  }
+}
+
+/* In-place transpose of a square (n x n) array. Tiles above the diagonal are swapped with their mirror tiles
+ * below it: the upper tile is transposed into a small buffer, the lower tile is transposed straight into the
+ * upper position, and the buffer is copied into the lower position. Diagonal tiles go through the buffer alone.
+ * Tiles are visited in 32x32 blocks, so both mirror blocks stay in cache while they are being swapped.
+ */
+template<typename _NumericType>
+inline void transposeSquareInPlace( _NumericType* const data, const size_t n )
+{
+  constexpr size_t tile { microTileSize<_NumericType>() };
+  constexpr size_t block { 32 };
+  const size_t fullN { n - n % tile };
+  _NumericType buffer[tile * tile];
+
+  for ( size_t bi { 0ULL }; bi < fullN; bi += block )
+    for ( size_t bj { bi }; bj < fullN; bj += block )
+      for ( size_t i { bi }; i < std::min( bi + block, fullN ); i += tile )
+        for ( size_t j { (bi == bj) ? i : bj }; j < std::min( bj + block, fullN ); j += tile )
+        {
+          _NumericType* const upper { data + i * n + j };
+          _NumericType* const lower { data + j * n + i };
+          microTranspose( upper, n, buffer, tile );
+          if ( i != j )
+            microTranspose( static_cast<const _NumericType*>(lower), n, upper, n );
+          for ( size_t r { 0ULL }; r < tile; ++r )
+            std::copy( buffer + r * tile, buffer + (r + 1) * tile, lower + r * n );
+        }
+
+  // columns (and rows) beyond the last whole tile
+  for ( size_t i { 0ULL }; i < n; ++i )
+    for ( size_t j { std::max( i + 1, fullN ) }; j < n; ++j )
+      std::swap( data[i * n + j], data[j * n + i] );
+}
+
+/* In-place transpose of a non-square (rows x cols) array, by following permutation cycles.
+ * The element at flat index i*cols + j belongs at flat index j*rows + i after the transpose. Starting from
+ * any element, repeatedly moving the carried element to its destination and picking up the one found there
+ * walks a cycle that ends back at the start. One bit per element marks the positions already placed, so every
+ * cycle is walked once. The first and last elements never move.
+ * Time complexity ~ O(rows*cols), extra memory ~ rows*cols bits.
+ */
+template<typename _NumericType>
+inline void transposeCyclesInPlace( _NumericType* const data, const size_t rows, const size_t cols )
+{
+  const size_t size { rows * cols };
+  std::vector<bool> placed( size, false );
+
+  for ( size_t start { 1ULL }; start + 1 < size; ++start )
+  {
+    if ( placed[start] ) continue;
+
+    _NumericType carried { data[start] };
+    size_t current { start };
+    do
+    {
+      const size_t next { (current % cols) * rows + current / cols };
+      std::swap( data[next], carried );
+      placed[next] = true;
+      current = next;
+    } while ( current != start );
+  }
+}
+
+////////// Multiplication kernels //////////
+
+/* Multiply-accumulates one (_Rows x _Cols) tile of C over the whole inner dimension `k`. The tile is summed in a
+ * local array with constant bounds, so every step of `p` loads one row segment of B, broadcasts `_Rows` elements
+ * of A, and does `_Rows * _Cols` vectorized multiply-adds without touching C. With the 4 x 4 cache line tiles of
+ * `multiplyAccumulate` (128 doubles) the array does not fit in the 16 SIMD registers of SSE or AVX : it lives on
+ * the stack, in L1 cache, and each multiply-add also loads and stores its part of it. That is still faster than
+ * the register sized tiles tried, see `multiplyAccumulate`.
+ */
+template<typename _NumericType, size_t _Rows, size_t _Cols>
+inline void multiplyTile( const _NumericType* const a, const size_t lda, const _NumericType* const b,
+                          const size_t ldb, _NumericType* const c, const size_t ldc, const size_t k,
+                          const _NumericType alpha )
+{
+  _NumericType accumulator[_Rows][_Cols] { };
+  for ( size_t p { 0ULL }; p < k; ++p )
+  {
+    const _NumericType* const bRow { b + p * ldb };
+    for ( size_t row { 0ULL }; row < _Rows; ++row )
+    {
+      const _NumericType scale { a[row * lda + p] };
+      for ( size_t col { 0ULL }; col < _Cols; ++col )
+        accumulator[row][col] += scale * bRow[col];
+    }
+  }
+
+  for ( size_t row { 0ULL }; row < _Rows; ++row )
+    for ( size_t col { 0ULL }; col < _Cols; ++col )
+      c[row * ldc + col] += alpha * accumulator[row][col];
+}
+
+// Same as `multiplyTile`, for the partial tiles along the bottom and right edges of C.
+template<typename _NumericType>
+inline void multiplyEdge( const _NumericType* const a, const size_t lda, const _NumericType* const b, const size_t ldb,
+                          _NumericType* const c, const size_t ldc, const size_t m, const size_t k, const size_t n,
+                          const _NumericType alpha )
+{
+  for ( size_t row { 0ULL }; row < m; ++row )
+    for ( size_t p { 0ULL }; p < k; ++p )
+    {
+      const _NumericType scale { alpha * a[row * lda + p] };
+      for ( size_t col { 0ULL }; col < n; ++col )
+        c[row * ldc + col] += scale * b[p * ldb + col];
+    }
+}
+
+/* The panel buffer of `multiplyAccumulate` on the calling thread, of at least `count` elements, left uninitialized.
+ * It grows when a larger panel is needed and is kept until the thread ends, so a loop of products allocates it
+ * once per thread and element type : at most 256 KB, the size of a full panel.
+ */
+template<typename _NumericType>
+_NumericType* multiplyScratch( const size_t count )
+{
+  static thread_local std::unique_ptr<_NumericType[]> buffer;
+  static thread_local size_t capacity { 0ULL };
+  if ( count > capacity )
+  {
+    TRACE_ALLOCATION( count * sizeof( _NumericType ) );
+    buffer.reset();                                       // frees the smaller buffer before allocating the larger
+    buffer.reset( new _NumericType[count] );
+    capacity = count;
+  }
+  return buffer.get();
+}
+
+/* C is cut into tiles of 4 rows by 4 cache lines, each summed by `multiplyTile`. Narrower tiles tempt compilers
+ * into vectorizing along the inner dimension instead of along the row, which is several times slower.
+ * The inner dimension is cut into blocks of `innerBlock` and the columns into blocks of `colBlock`, so the
+ * (innerBlock x colBlock) panel of B read by all the tiles of a block row stays in L2 cache, and the 4 rows of A
+ * read by a tile stay in L1. When enough rows share it, the panel is first copied into the `multiplyScratch` buffer:
+ * rows of a large B can be a power of 2 bytes apart, and would then all compete for the same few cache sets.
+ */
+template<typename _NumericType>
+void multiplyAccumulate( const _NumericType* const a, const size_t lda, const _NumericType* const b, const size_t ldb,
+                         _NumericType* const c, const size_t ldc, const size_t m, const size_t k, const size_t n,
+                         const _NumericType alpha )
+{
+  constexpr size_t tileRows { 4 };
+  constexpr size_t tileCols { std::max<size_t>( 256 / sizeof( _NumericType ), 1 ) };
+  constexpr size_t innerBlock { 256 };
+  constexpr size_t colBlock { std::max<size_t>( 256 * 1024 / sizeof( _NumericType ) / innerBlock, tileCols ) };
+  constexpr size_t packRows { 4 * tileRows };
+
+  const bool pack { m >= packRows };
+  const size_t panelSize { std::min( innerBlock, k ) * std::min( colBlock, n ) };
+  _NumericType* const packed { pack ? multiplyScratch<_NumericType>( panelSize ) : nullptr };
+
+  const size_t fullRows { m - m % tileRows };
+  for ( size_t col0 { 0ULL }; col0 < n; col0 += colBlock )
+  {
+    const size_t width { std::min( colBlock, n - col0 ) };
+    const size_t fullWidth { width - width % tileCols };
+    for ( size_t p0 { 0ULL }; p0 < k; p0 += innerBlock )
+    {
+      const size_t depth { std::min( innerBlock, k - p0 ) };
+      const _NumericType* const aBlock { a + p0 };
+      const _NumericType* panel { b + p0 * ldb + col0 };
+      size_t ldp { ldb };
+      if ( pack )
+      {
+        for ( size_t p { 0ULL }; p < depth; ++p )
+          std::copy( panel + p * ldb, panel + p * ldb + width, packed + p * width );
+        panel = packed;
+        ldp = width;
+      }
+
+      for ( size_t row { 0ULL }; row < fullRows; row += tileRows )
+      {
+        _NumericType* const cRow { c + row * ldc + col0 };
+        for ( size_t col { 0ULL }; col < fullWidth; col += tileCols )
+          multiplyTile<_NumericType, tileRows, tileCols>( aBlock + row * lda, lda, panel + col, ldp,
+                                                          cRow + col, ldc, depth, alpha );
+        multiplyEdge( aBlock + row * lda, lda, panel + fullWidth, ldp, cRow + fullWidth, ldc,
+                      tileRows, depth, width - fullWidth, alpha );
+      }
+      multiplyEdge( aBlock + fullRows * lda, lda, panel, ldp, c + fullRows * ldc + col0, ldc,
+                    m - fullRows, depth, width, alpha );
+    }
+  }
+}
+
+////////// Matrix //////////
+
+// Basic constructor.
+template<typename _NumericType>
+Matrix<_NumericType>::Matrix( const size_t rows, const size_t cols ) :
+  __rows { rows },
+  __cols { cols },
+  __data { (rows && cols) ? pool_make_array<_NumericType>( rows * cols ) : nullptr }
+{
+  if ( !__data ) throw std::invalid_argument { "error: matrix has either 0 rows or 0 columns or both.\n" };
+}
+
+/* This constructor accepts the dimensions of the matrix and an initializer list to fill in.
+ * It checks if the initializer list shape exceeds that of the matrix to throw an error.
+ * In case of list being smaller than the matrix, the remaining values are left zero-initialized.
+ */
+template<typename _NumericType>
+Matrix<_NumericType>::Matrix( const size_t rows, const size_t cols, InitializerList2D list ) :
+  Matrix { rows, cols }
+{
+  if ( rows < list.size() )
+    throw std::invalid_argument { "error: too many rows to unpack into Matrix.\n" };
+
+  auto row_begin { __data.get() };
+  for ( auto innerlist : list )
+  {
+    if ( cols < innerlist.size() )
+      throw std::invalid_argument { "error: too many columns to unpack into Matrix.\n" };
+
+    std::copy( innerlist.begin(), innerlist.end(), row_begin );
+    row_begin += cols;
+  }
+}
+
+/* Custom copy constructor, called whenever object is passed by value.
+ * Default copy constructor would copy the pointers directly.
+ * So when the copy goes out of scope, its destructor will (wrongly) delete the pointers allocated by original object.
+ * Later, when the original goes out of scope, its destructor will try to delete the dangling pointer and crash.
+ * This constructor creates a deep copy to prevent the above issue, i.e copy has distinct pointers.
+ * Time complexity ~ O(n^2) or O(rows*cols).
+ */
+template<typename _NumericType>
+Matrix<_NumericType>::Matrix( const Matrix& copy ) :
+  Matrix { copy.__rows, copy.__cols }
+{
+  // copying only the data pointed by original's pointer to copy's distinct pointer
+  std::copy( copy.begin(), copy.end(), this->begin() );
+  TRACE_MOVED( __rows * __cols * sizeof( _NumericType ) );
+}
+
+/* Custom move constructor, called whenever an Matrix R-value is used to initiate an Matrix object.
+ * Its purpose is the same as the copy constructor, but it is faster than a copy constructor initialized by an
+ * Matrix R-value because it directly takes ownership of all assets of Matrix parameter, leaving it in an
+ * effectively "useless state". Whereas, copy constructor does not affect data owned by the Matrix parameter and
+ * copies all the data to the current object.
+ * Time complexity ~ O(1).
+ */
+template<typename _NumericType>
+Matrix<_NumericType>::Matrix( Matrix&& temp ) noexcept :
+  __rows { temp.__rows },
+  __cols { temp.__cols },
+  __data { std::move( temp.__data ) }             // "stealing" temp's array into the object being constructed
+{ }
+
+// Returns the value of rows attribute.
+template<typename _NumericType>
+inline
+const size_t Matrix<_NumericType>::rows() const { return __rows; }
+
+// Returns the value of columns attribute.
+template<typename _NumericType>
+inline
+const size_t Matrix<_NumericType>::cols() const { return __cols; }
+
+/* Returns a non-const iterator to the start of the array so that the loop variable inside a range-based `for` loop
+ * has the option to be modifiable or read-only, depending on the type of the iterator.
+ * for (auto x : Arr) - elements of Arr are read-only.
+ * for (auto& x : Arr) - elements of Arr are referenced and modified directly.
+ */
+template<typename _NumericType>
+inline
+_NumericType* Matrix<_NumericType>::begin() const { return __data.get(); }
+
+// Returns a const iterator to the end of the array, since it is used only for bound-checking.
+template<typename _NumericType>
+inline
+_NumericType* const Matrix<_NumericType>::end() const { return __data.get() + __rows * __cols; }
+
+/* This function is called for the first index (rows) of the array.
+ * It returns a `Row` object, which calls the subscript method for the second index (columns).
+ */
+template<typename _NumericType>
+typename Matrix<_NumericType>::Row Matrix<_NumericType>::operator[]( const size_t row ) const
+{
+  if ( row >= __rows )
+    throw std::out_of_range { "error: row index out of bounds.\n" };
+
+  return Row { __data.get() + row * __cols, __cols };
+}
+
+/* Copy assignment operator for Matrix.
+ * Rows and columns of LHS and RHS are expected to be equal before assignment.
+ * All the data pointed by RHS pointer is copied to LHS pointer.
+ * Pointers themselves are not copied to avoid multiple references to same data.
+ * Time complexity ~ O(n^2) or O(rows*cols).
+ */
+ //template<typename _NumericType>
+ //void Matrix<_NumericType>::operator=( const Matrix& copy )
+ //{
+ //  if ( this->__rows != copy.__rows || this->__cols != copy.__cols )
+ //    throw std::invalid_argument { "error: source and target matrix dimensions do not match.\n" };
+ //
+ //  std::copy( copy.begin(), copy.end(), this->begin() );
+ //}
+
+ /* Move assignment operator for Matrix.
+  * Rows and columns of LHS and RHS are expected to be equal before assignment.
+  * Pointers are swapped with the temporary object, since it is destroyed at end of this function.
+  * Time complexity ~ O(1).
+  */
+  //template<typename _NumericType>
+  //void Matrix<_NumericType>::operator=( Matrix&& temp ) noexcept
+  //{
+  //  if ( this->__rows != temp.__rows || this->__cols != temp.__cols )
+  //    throw std::invalid_argument { "error: source and target matrix dimensions do not match.\n" };
+  //
+  //  __data = std::move( temp.__data );
+  //}
+
+  /* Copy-and-Swap idiom (both Move and Copy assignment)
+  /// If this operator is uncommented, comment both copy and move assignment operator overloads above; they will be unnecessary. ///
+  /// This implementation is better in the general case of assigning (replacing) Matrix objects even if they have different sizes. ///
+  /// Utilizes the respective constructor to make the necessary argument object, removing any possibility of bugs in this operator. ///
+   * If an r-value Matrix is passed as an argument, then argument `mat` will be constructed using the move constructor from an r-value.
+   * If an l-value Matrix is passed as an argument, then argument `mat` will be constructed using the copy constructor from an l-value.
+   * Time complexity depends on the type of constructor used for argument `mat`.
+   * Time complexity ~ O(1) [move constructed] OR O(n^2) [copy constructed]
+   */
+template<typename _NumericType>
+void Matrix<_NumericType>::operator=( Matrix mat )
+{
+  if ( this->__rows != mat.__rows || this->__cols != mat.__cols )
+    throw std::invalid_argument { "error: source and target matrix dimensions do not match.\n" };
+
+  __data = std::move( mat.__data );
+}
+
+// Overload for unary positive operator. Constant time complexity.
+template<typename _NumericType>
+Matrix<_NumericType> Matrix<_NumericType>::operator+() const { return *this; }
+
+constexpr size_t matrixParallelElements { 1 << 16 };    // elements per block of the element-wise operations under `par`
+constexpr size_t matrixParallelRows { 64 };               // rows of the result per block of a product under `par`
+constexpr size_t matrixParallelProduct { 1 << 18 };       // m*k*n below which a product stays on the calling thread
+
+/* Runs `block( first, last )` once over [0, count) under a serial policy, or on blocks of `grain` values spread
+ * over `ThreadPool::shared()` under a parallel one. Blocks must write disjoint parts of the result.
+ * Work of at most one block is not worth waking the pool for, and stays on the calling thread.
+ */
+template<typename _NumericType>
+template<typename _ExecutionPolicy, typename _Block>
+void Matrix<_NumericType>::__forBlocks( const size_t count, const size_t grain, const _Block& block )
+{
+  if constexpr ( isParallelPolicy<_ExecutionPolicy> )
+    if ( count > grain )
+    {
+      parallelBlocks( count, grain, block );
+      return;
+    }
+  block( size_t { 0 }, count );
+}
+
+/* Adds 2 matrices of same dimensions under an execution policy, see `operator+`.
+ * Time complexity ~ O(n^2) or O(rows*cols).
+ */
+template<typename _NumericType>
+template<typename _ExecutionPolicy, typename>
+Matrix<_NumericType> Matrix<_NumericType>::add( _ExecutionPolicy&&, const Matrix& other ) const
+{
+  TRACE_SCOPE( "Matrix::add" );
+  if ( this->__rows != other.__rows || this->__cols != other.__cols )
+    throw std::invalid_argument { "error: dimensions of addend matrices do not match.\n" };
+
+  Matrix result { __rows, __cols };
+  __forBlocks<_ExecutionPolicy>( __rows * __cols, matrixParallelElements, [&] ( const size_t first, const size_t last )
+  {
+    for ( size_t i { first }; i < last; ++i )
+      result.__data[i] = this->__data[i] + other.__data[i];
+  } );
+
+  return result;
+}
+
+/* Overload for adding 2 matrices of same dimensions.
+ * Rows and columns of LHS and RHS are expected to be equal before addition.
+ * Time complexity ~ O(n^2) or O(rows*cols).
+ */
+template<typename _NumericType>
+inline
+Matrix<_NumericType> Matrix<_NumericType>::operator+( const Matrix& other ) const
+{
+  return add( std::execution::seq, other );
+}
+
+/* Overload for shorthand addition, straightforward implementation using addition overload.
+ * Time complexity is same as addition ~ O(n^2) or O(rows*cols).
+ */
+template<typename _NumericType>
+inline
+void Matrix<_NumericType>::operator+=( const Matrix& other ) { *this = *this + other; }
+
+/* Overload for inverting the sign of all elements of a matrix.
+ * Time complexity is same as multiplication with a scalar ~ O(n^2) or O(rows*cols).
+ */
+template<typename _NumericType>
+inline
+Matrix<_NumericType> Matrix<_NumericType>::operator-() const { return *this * -1; }
+
+/* Subtracts 2 matrices of same dimensions under an execution policy, see `operator-`.
+ * Time complexity ~ O(n^2) or O(rows*cols).
+ */
+template<typename _NumericType>
+template<typename _ExecutionPolicy, typename>
+Matrix<_NumericType> Matrix<_NumericType>::subtract( _ExecutionPolicy&&, const Matrix& other ) const
+{
+  TRACE_SCOPE( "Matrix::subtract" );
+  if ( this->__rows != other.__rows || this->__cols != other.__cols )
+    throw std::invalid_argument { "error: minuend and subtrahend matrix dimensions do not match.\n" };
+
+  Matrix result { __rows, __cols };
+  __forBlocks<_ExecutionPolicy>( __rows * __cols, matrixParallelElements, [&] ( const size_t first, const size_t last )
+  {
+    for ( size_t i { first }; i < last; ++i )
+      result.__data[i] = this->__data[i] - other.__data[i];
+  } );
+
+  return result;
+}
+
+/* Overload for subtraction between 2 matrices of same dimensions.
+ * Rows and columns of LHS and RHS are expected to be equal before subtraction.
+ * Time complexity ~ O(n^2) or O(rows*cols).
+ */
+template<typename _NumericType>
+inline
+Matrix<_NumericType> Matrix<_NumericType>::operator-( const Matrix& other ) const
+{
+  return subtract( std::execution::seq, other );
+}
+
+/* Overload for shorthand subtraction, straightforward implementation using subtraction overload.
+ * Time complexity is same as subtraction ~ O(n^2) or O(rows*cols).
+ */
+template<typename _NumericType>
+inline
+void Matrix<_NumericType>::operator-=( const Matrix& other ) { *this = *this - other; }
+
+/* Multiplies the (m x k) array `lhs` with the (k x n) array `rhs`, overwriting the (m x n) array `out`.
+ * `out` must not alias either operand. The work is done by the tiled `multiplyAccumulate` kernel: every element
+ * of `lhs` scales a contiguous row segment of `rhs`, so `rhs` is streamed row by row instead of being walked
+ * down its columns (one cache line per element), and the innermost loop vectorizes.
+ * Under a parallel policy, every block of `matrixParallelRows` rows of `out` is a product of its own, with the
+ * matching rows of `lhs` and all of `rhs`.
+ * Naive algorithm, time complexity ~ O(n^3) ~ O(m*k*n).
+ */
+template<typename _NumericType>
+template<typename _ExecutionPolicy>
+void Matrix<_NumericType>::__multiplyInto( const _NumericType* const lhs, const _NumericType* const rhs,
+                                           _NumericType* const out, const size_t m, const size_t k, const size_t n )
+{
+  TRACE_SCOPE( "Matrix::multiply" );
+  const size_t grain { (m * k * n < matrixParallelProduct) ? m : matrixParallelRows };
+  __forBlocks<_ExecutionPolicy>( m, grain, [=] ( const size_t first, const size_t last )
+  {
+    std::fill( out + first * n, out + last * n, _NumericType { } );
+    multiplyAccumulate( lhs + first * k, k, rhs, n, out + first * n, n, last - first, k, n );
+  } );
+}
+
+/* Multiplies two Matrix objects under an execution policy, see `operator*`.
+ * Naive algorithm, time complexity ~ O(n^3) ~ O(rows1*cols1*cols2).
+ */
+template<typename _NumericType>
+template<typename _ExecutionPolicy, typename>
+Matrix<_NumericType> Matrix<_NumericType>::multiply( _ExecutionPolicy&&, const Matrix& other ) const
+{
+  if ( this->__cols != other.__rows )
+    throw std::invalid_argument { "error: dimensions of multiplicand matrices are incompatible for multiplication.\n" };
+
+  Matrix result { this->__rows, other.__cols };
+  __multiplyInto<std::decay_t<_ExecutionPolicy>>( __data.get(), other.__data.get(), result.__data.get(),
+                                                   __rows, __cols, other.__cols );
+
+  return result;
+}
+
+/* Overload for multiplication of two Matrix objects.
+ * Checks the matrix multiplication dimensions prerequisite.
+ * Returns the resultant Matrix object.
+ * Naive algorithm, time complexity ~ O(n^3) ~ O(rows1*cols1*cols2).
+ */
+template<typename _NumericType>
+inline
+Matrix<_NumericType> Matrix<_NumericType>::operator*( const Matrix& other ) const
+{
+  return multiply( std::execution::seq, other );
+}
+
+/* Multiplies every element of matrix with a scalar value under an execution policy, see `operator*`.
+ * Time complexity ~ O(n^2) or O(rows*cols).
+ */
+template<typename _NumericType>
+template<typename _ExecutionPolicy, typename>
+Matrix<_NumericType> Matrix<_NumericType>::scale( _ExecutionPolicy&&, const _NumericType value ) const
+{
+  TRACE_SCOPE( "Matrix::scale" );
+  Matrix result { __rows, __cols };
+  __forBlocks<_ExecutionPolicy>( __rows * __cols, matrixParallelElements, [&] ( const size_t first, const size_t last )
+  {
+    for ( size_t i { first }; i < last; ++i )
+      result.__data[i] = this->__data[i] * value;
+  } );
+
+  return result;
+}
+
+/* Overload for multiplying every element of matrix with a scalar value.
+ * Time complexity ~ O(n^2) or O(rows*cols).
+ */
+template<typename _NumericType>
+inline
+Matrix<_NumericType> Matrix<_NumericType>::operator*( const _NumericType value ) const
+{
+  return scale( std::execution::seq, value );
+}
+
+/* Overload for shorthand multiplication, straightforward implementation using multiplication overload.
+ * Time complexity is same as multiplication ~ O(n^3) ~ O(rows1*cols1*cols2).
+ */
+template<typename _NumericType>
+inline
+void Matrix<_NumericType>::operator*=( const Matrix& other ) { *this = *this * other; }
+
+/* Raises a square matrix to a non-negative integer power, using exponentiation by squaring (see `power` in algos.h).
+ * Going through `operator*=` would allocate a new result for every product. Instead, exactly 3 buffers are used
+ * (result, running square and scratch): every product is written into the scratch buffer, which is then swapped
+ * with its destination. As in `power`, the squaring after the highest bit of `exp` is skipped.
+ * Time complexity ~ O(n^3 * log(exp)), with 3 allocations regardless of `exp` (the products pack their panels into
+ * the buffer kept by their thread, see `multiplyScratch`).
+ */
+template<typename _NumericType>
+Matrix<_NumericType> Matrix<_NumericType>::pow( std::uint64_t exp ) const
+{
+  TRACE_SCOPE( "Matrix::pow" );
+  if ( __rows != __cols )
+    throw std::invalid_argument { "error: only square matrices can be raised to a power.\n" };
+
+  const size_t n { __rows };
+  Matrix result { n, n };
+  for ( size_t i { 0ULL }; i < n; ++i )
+    result.__data[i * n + i] = _NumericType { 1 };
+  if ( !exp ) return result;
+
+  Matrix base { *this };
+  Matrix scratch { n, n };
+  while ( true )
+  {
+    if ( exp & 1 )
+    {
+      __multiplyInto( result.__data.get(), base.__data.get(), scratch.__data.get(), n, n, n );
+      result.__data.swap( scratch.__data );
+    }
+
+    exp >>= 1;
+    if ( !exp ) break;
+
+    __multiplyInto( base.__data.get(), base.__data.get(), scratch.__data.get(), n, n, n );
+    base.__data.swap( scratch.__data );
+  }
+
+  return result;
+}
+
+/* Returns a new (cols x rows) matrix holding the transpose, see `transposeRecursive`.
+ * Time complexity ~ O(rows*cols), with about one cache miss per cache line instead of one per element.
+ */
+template<typename _NumericType>
+Matrix<_NumericType> Matrix<_NumericType>::transpose() const
+{
+  TRACE_SCOPE( "Matrix::transpose" );
+  TRACE_MOVED( __rows * __cols * sizeof( _NumericType ) );
+  Matrix result { __cols, __rows };
+  transposeRecursive( __data.get(), __cols, result.__data.get(), __rows, __rows, __cols );
+  return result;
+}
+
+/* Overwrites `result` with the transpose, for callers that reuse a destination buffer instead of allocating.
+ * Throws an exception if `result` is not (cols x rows), or if it is this matrix (use `transposeInPlace`).
+ */
+template<typename _NumericType>
+void Matrix<_NumericType>::transpose( Matrix& result ) const
+{
+  if ( result.__rows != __cols || result.__cols != __rows )
+    throw std::invalid_argument { "error: target matrix dimensions do not match the transpose.\n" };
+  if ( &result == this )
+    throw std::invalid_argument { "error: target of an out-of-place transpose can not be the source matrix.\n" };
+  TRACE_SCOPE( "Matrix::transpose" );
+  TRACE_MOVED( __rows * __cols * sizeof( _NumericType ) );
+
+  transposeRecursive( __data.get(), __cols, result.__data.get(), __rows, __rows, __cols );
+}
+
+/* Transposes the matrix within its own array and swaps the number of rows and columns.
+ * Square matrices swap mirror tiles (no extra memory), other shapes follow permutation cycles (1 bit per element).
+ * Note that this changes the shape, so a transposed non-square matrix can no longer be assigned to or from
+ * matrices of its old shape.
+ * Time complexity ~ O(rows*cols).
+ */
+template<typename _NumericType>
+void Matrix<_NumericType>::transposeInPlace()
+{
+  TRACE_SCOPE( "Matrix::transposeInPlace" );
+  TRACE_MOVED( __rows * __cols * sizeof( _NumericType ) );
+  if ( __rows == __cols )
+    transposeSquareInPlace( __data.get(), __rows );
+  else
+    transposeCyclesInPlace( __data.get(), __rows, __cols );
+
+  std::swap( __rows, __cols );
+}
+
+/* Prints the contents of the array in its given shape.
+ * Time complexity ~ O(n^2) or O(rows*cols).
+ */
+template<typename _NumericType>
+void Matrix<_NumericType>::view() const
+{
+  for ( size_t row { 0ULL }; row < __rows; ++row )
+  {
+    for ( size_t col { 0ULL }; col < __cols; ++col )
+      std::cout << __data[row * __cols + col] << ' ';
+    std::cout << '\n';
+  }
+  std::cout << '\n';
+}
+
+/* Overload to make scalar matrix multiplication commutative.
+ * Implemented using the Matrix class overload.
+ * Time complexity ~ O(n^2) or O(rows*cols).
+ */
+template<typename _NumericType>
+inline
+Matrix<_NumericType> operator*( const _NumericType value, const Matrix<_NumericType>& mat ) { return mat * value; }
 
 /*/////////////////////////////////////// Python-like Range iterator in for-each loop /////////////////////////////////////////
  *
- * We store the ending and starting values, where the starting value gets wrapped by an iterator and
- * compared to the ending value by the for-each loop internally. We create an iterator class because
- * the internal implementation uses indirection operator on the iterator. Except for this one operation,
- * all other operations are compatible with integral types, i.e this iterator "wrapper" is created only
- * for the sake of indirection operation.
- * And we also overload all the necessary operators that are internally used by the for-each
- * implementation. ( Under-the-hood working : https://en.cppreference.com/w/cpp/language/range-for )
- * A `const IntRange` object makes no sense.
+ * A sized random-access range of the values begin, begin + step, begin + 2*step, ... stopping before "end", whatever
+ * the distance between them (`IntRange{10, 200, 30}` has the 7 values 10 to 190). The sign of `step` is corrected
+ * to point from begin to end, so `IntRange{2000, 30, -100}` and `IntRange{2000, 30, 100}` are the same range.
+ * The number of values is computed once by the constructor, so the iterator is just an index into the range :
+ * the end iterator is the index `size()`, and the for-each loop compares indices exactly like a plain index loop,
+ * so compilers know the trip count and vectorize the loop body. Values are computed as begin + index * step in the
+ * unsigned type of the same width, which wraps instead of overflowing, and every value inside the range fits.
+ * Indices are `std::ptrdiff_t`, so a range can hold at most PTRDIFF_MAX values : the constructor throws for more,
+ * e.g. for the whole range of `std::int64_t` with a step of 1 (more than 2^63 values).
+ * Everything is defined in the class, so loops over a range inline in every translation unit.
+ * ( Under-the-hood working : https://en.cppreference.com/w/cpp/language/range-for )
  */
 template<typename _Integer>
 class IntRange
 {
-  class Iterator                                          // wrapper class for the iterating variable
+  static_assert( std::is_integral_v<_Integer> && std::is_signed_v<_Integer>, "IntRange requires a signed integer type" );
+  using _Unsigned = std::make_unsigned_t<_Integer>;
+
+  _Integer __begin;                                       // holds the starting value
+  _Integer __step;                                        // holds the step value, pointing towards the ending value
+  size_t __size;                                          // holds the number of values
+
+  // begin + index * step, wrapping in the unsigned type instead of overflowing
+  static _Integer __valueAt( const _Integer begin, const _Integer step, const std::ptrdiff_t index )
+  {
+    return static_cast<_Integer>(static_cast<_Unsigned>(begin)
+                                 + static_cast<_Unsigned>(index) * static_cast<_Unsigned>(step));
+  }
+
+public:
+
+  class Iterator                                          // position in the range, random access
   {
-    _Integer __value;
-    const _Integer __step;
+    _Integer __begin;                                     // starting value of the range
+    _Integer __step;                                      // step value of the range
+    std::ptrdiff_t __index;                               // number of steps from the start
 
   public:
 
-    Iterator( const _Integer value, const _Integer step );
-    bool operator!=( const _Integer other );
-    _Integer operator*();
-    Iterator& operator++();
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = _Integer;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = _Integer;                           // values are computed, not stored
+
+    Iterator() : __begin { 0 }, __step { 1 }, __index { 0 } { }
+    Iterator( const _Integer begin, const _Integer step, const std::ptrdiff_t index ) :
+      __begin { begin }, __step { step }, __index { index } { }
+
+    _Integer operator*() const { return __valueAt( __begin, __step, __index ); }
+    _Integer operator[]( const std::ptrdiff_t offset ) const { return __valueAt( __begin, __step, __index + offset ); }
+
+    Iterator& operator++() { ++__index; return *this; }
+    Iterator operator++( int ) { Iterator old { *this }; ++__index; return old; }
+    Iterator& operator--() { --__index; return *this; }
+    Iterator operator--( int ) { Iterator old { *this }; --__index; return old; }
+    Iterator& operator+=( const std::ptrdiff_t offset ) { __index += offset; return *this; }
+    Iterator& operator-=( const std::ptrdiff_t offset ) { __index -= offset; return *this; }
+    Iterator operator+( const std::ptrdiff_t offset ) const { return Iterator { __begin, __step, __index + offset }; }
+    Iterator operator-( const std::ptrdiff_t offset ) const { return Iterator { __begin, __step, __index - offset }; }
+    friend Iterator operator+( const std::ptrdiff_t offset, const Iterator& it ) { return it + offset; }
+    std::ptrdiff_t operator-( const Iterator& other ) const { return __index - other.__index; }
+
+    // iterators are only compared within the same range, so the index alone decides
+    bool operator==( const Iterator& other ) const { return __index == other.__index; }
+    bool operator!=( const Iterator& other ) const { return __index != other.__index; }
+    bool operator<( const Iterator& other ) const { return __index < other.__index; }
+    bool operator<=( const Iterator& other ) const { return __index <= other.__index; }
+    bool operator>( const Iterator& other ) const { return __index > other.__index; }
+    bool operator>=( const Iterator& other ) const { return __index >= other.__index; }
   };
 
-  const _Integer __begin;                                 // holds the starting value
-  const _Integer __end;                                   // holds the halting value
-  const _Integer __step;                                  // holds the step value to move the iterator
+  // initializes the range, throws an exception if `step` is 0 or if the range has more than PTRDIFF_MAX values
+  IntRange( const _Integer begin, const _Integer end, const _Integer step = 1 ) :
+    __begin { begin },
+    __step { 0 },
+    __size { 0 }
+  {
+    if ( step == 0 )
+      throw std::invalid_argument { "error: IntRange step must not be 0.\n" };
 
-public:
+    // distance and |step| in the unsigned type, which holds them even for the extreme values of `_Integer`
+    const _Unsigned first { static_cast<_Unsigned>(begin) }, last { static_cast<_Unsigned>(end) };
+    const _Unsigned distance { static_cast<_Unsigned>((begin < end) ? last - first : first - last) };
+    const _Unsigned stride { static_cast<_Unsigned>((step < 0) ? _Unsigned { 0 } - static_cast<_Unsigned>(step) : step) };
+    // correctly initializes step value irrespective of sign mismatch by the user
+    __step = static_cast<_Integer>((begin < end) ? stride : static_cast<_Unsigned>(_Unsigned { 0 } - stride));
+    const _Unsigned count { static_cast<_Unsigned>(distance / stride + (distance % stride != 0)) };
+    if ( static_cast<std::uint64_t>(count) > static_cast<std::uint64_t>(std::numeric_limits<std::ptrdiff_t>::max()) )
+      throw std::length_error { "error: IntRange has more values than its indices can count.\n" };
+    __size = static_cast<size_t>(count);
+  }
+
+  // overload for missing `begin`, no step parameter to avoid ambiguous call
+  IntRange( const _Integer end ) :
+    IntRange { 0, end, 1 }    // calling the overloaded constructor with all parameters
+  { }
+
+  Iterator begin() const { return Iterator { __begin, __step, 0 }; }   // returns an iterator to the start point
+  Iterator end() const                                    // returns the iterator one position after the last value
+  {
+    return Iterator { __begin, __step, static_cast<std::ptrdiff_t>(__size) };
+  }
+  size_t size() const { return __size; }                  // returns the number of values, in constant time
+  bool empty() const { return __size == 0; }              // returns true if there are no values
+  _Integer step() const { return __step; }                // returns the step, with the sign corrected
+  _Integer operator[]( const size_t index ) const         // returns the value at `index`, unchecked
+  {
+    return __valueAt( __begin, __step, static_cast<std::ptrdiff_t>(index) );
+  }
+
+  // returns the `count` values from `index` on as a range of their own, unchecked
+  IntRange subrange( const size_t index, const size_t count ) const
+  {
+    IntRange part { *this };
+    part.__begin = (*this)[index];
+    part.__size = count;
+    return part;
+  }
+
+  /* Splits the range into `parts` consecutive subranges (fewer if there are fewer values), whose sizes differ by
+   * at most 1, for parallel loops : each thread takes one subrange. Throws an exception if `parts` is 0.
+   */
+  std::vector<IntRange> split( size_t parts ) const
+  {
+    if ( parts == 0 )
+      throw std::invalid_argument { "error: IntRange can not be split into 0 parts.\n" };
+    parts = (__size < parts) ? (__size ? __size : 1) : parts;
 
-  // specify default argument either in declaration or in definition, but not both 
-  // (for forward-declared functions) - counts as a redeclaration of default argument
-  IntRange( const _Integer begin, const _Integer end, const _Integer step = 1 );    // initializes the 2 attributes
-  IntRange( const _Integer end );                         // overload for missing `begin`, no step parameter to avoid ambiguous call
-  Iterator begin();                                       // returns an iterator to the start point
-  const _Integer end();                                   // returns the ending value
+    std::vector<IntRange> subranges;
+    subranges.reserve( parts );
+    size_t first { 0 };
+    for ( size_t part { 0 }; part < parts; ++part )
+    {
+      const size_t count { __size / parts + (part < __size % parts) };
+      subranges.push_back( subrange( first, count ) );
+      first += count;
+    }
+    return subranges;
+  }
 };
 
-void testIntRange();                                      // demo function
+void testIntRange();                                      // demo function and benchmark against plain index loops
 
 #endif
\ No newline at end of file
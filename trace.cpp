@@ -0,0 +1,279 @@
+// Implementation of the tracing layer described in `trace.h`, and its demo
+
+#include "trace.h"
+#include "fibonacci.h"      // fibonacci_range
+#include "sort.h"           // sort, SortType
+#include "structs.h"        // Matrix
+
+#include <algorithm>        // std::max
+#include <chrono>           // std::chrono::steady_clock, std::chrono::nanoseconds
+#include <fstream>          // std::ofstream
+#include <iomanip>          // std::setw, std::setprecision
+#include <map>              // std::map
+#include <memory>           // std::unique_ptr, std::make_unique
+#include <mutex>            // std::mutex, std::lock_guard
+#include <random>           // std::mt19937, std::uniform_int_distribution
+#include <stdexcept>        // std::runtime_error
+#include <vector>           // std::vector
+
+// Names are literals or generated by the benchmark suites, but a quote or a backslash would still break the JSON.
+void write_json_string( std::ostream& out, const std::string& text )
+{
+  out << '"';
+  for ( const char c : text )
+  {
+    if ( c == '"' || c == '\\' ) out << '\\';
+    out << c;
+  }
+  out << '"';
+}
+
+#ifdef TRACE_ENABLED
+
+static const char* const counterNames[traceCounters] { "allocations", "allocatedBytes", "movedBytes" };
+
+// one closed scope, as kept in the ring of its thread
+struct TraceEvent
+{
+  std::uint32_t site;
+  std::uint64_t start;                                    // nanoseconds since `traceEpoch`
+  std::uint64_t duration;                                 // nanoseconds
+  std::uint64_t counters[traceCounters];                  // growth of the thread's counters during the scope
+};
+
+// every scope of one call site, on one thread
+struct SiteStatistics
+{
+  std::uint64_t calls;
+  std::uint64_t total;                                    // nanoseconds, inclusive of nested scopes
+  std::uint64_t longest;
+  std::uint64_t counters[traceCounters];
+};
+
+// Written only by its own thread. The ring grows up to `traceCapacity` events, so idle threads stay small.
+struct TraceThread
+{
+  std::uint32_t index;                                    // in order of first use, the track in the Chrome trace
+  std::vector<TraceEvent> events;
+  std::uint64_t written { 0 };                            // events ever recorded; the newest is at (written - 1) % capacity
+  std::uint64_t counters[traceCounters] { };
+  std::vector<SiteStatistics> sites;                      // indexed by `TraceSite::id`
+};
+
+static const std::chrono::steady_clock::time_point traceEpoch { std::chrono::steady_clock::now() };
+
+// the registries : every site name by id, and the buffers of every thread that ever traced
+static std::mutex registryMutex;
+static std::vector<const char*> siteNames;
+static std::vector<std::unique_ptr<TraceThread>> threads;
+
+static std::uint64_t now()
+{
+  return static_cast<std::uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - traceEpoch ).count() );
+}
+
+// The buffers of the calling thread, registered on its first event. The registry owns them, so they outlive the thread.
+static TraceThread& currentThread()
+{
+  static thread_local TraceThread* current { nullptr };
+  if ( !current )
+  {
+    const std::lock_guard<std::mutex> lock { registryMutex };
+    threads.push_back( std::make_unique<TraceThread>() );
+    current = threads.back().get();
+    current->index = static_cast<std::uint32_t>(threads.size() - 1);
+  }
+  return *current;
+}
+
+TraceSite::TraceSite( const char* const name ) :
+  __name { name },
+  __id { [name]
+  {
+    const std::lock_guard<std::mutex> lock { registryMutex };
+    siteNames.push_back( name );
+    return static_cast<std::uint32_t>(siteNames.size() - 1);
+  }() }
+{ }
+
+TraceScope::TraceScope( const TraceSite& site ) :
+  __site { site },
+  __buffers { currentThread() }
+{
+  std::copy( __buffers.counters, __buffers.counters + traceCounters, __counters );
+  __start = now();                                        // last, so the setup is not timed
+}
+
+TraceScope::~TraceScope()
+{
+  const std::uint64_t end { now() };
+  TraceEvent event { __site.id(), __start, end - __start, { } };
+  for ( size_t i { 0 }; i < traceCounters; ++i )
+    event.counters[i] = __buffers.counters[i] - __counters[i];
+
+  if ( __buffers.events.size() < traceCapacity )
+    __buffers.events.push_back( event );
+  else
+    __buffers.events[__buffers.written % traceCapacity] = event;
+  ++__buffers.written;
+
+  if ( __buffers.sites.size() <= event.site )
+    __buffers.sites.resize( event.site + 1 );
+  SiteStatistics& statistics { __buffers.sites[event.site] };
+  ++statistics.calls;
+  statistics.total += event.duration;
+  statistics.longest = std::max( statistics.longest, event.duration );
+  for ( size_t i { 0 }; i < traceCounters; ++i )
+    statistics.counters[i] += event.counters[i];
+}
+
+void trace_count( const TraceCounter counter, const std::uint64_t amount )
+{
+  currentThread().counters[static_cast<size_t>(counter)] += amount;
+}
+
+void trace_summary( std::ostream& out )
+{
+  const std::lock_guard<std::mutex> lock { registryMutex };
+
+  // the instances of a template have a site each, under one name
+  std::map<std::string, SiteStatistics> byName;
+  for ( const auto& thread : threads )
+    for ( size_t site { 0 }; site < thread->sites.size(); ++site )
+    {
+      const SiteStatistics& statistics { thread->sites[site] };
+      if ( !statistics.calls ) continue;
+      SiteStatistics& merged { byName[siteNames[site]] };
+      merged.calls += statistics.calls;
+      merged.total += statistics.total;
+      merged.longest = std::max( merged.longest, statistics.longest );
+      for ( size_t i { 0 }; i < traceCounters; ++i )
+        merged.counters[i] += statistics.counters[i];
+    }
+
+  out << std::left << std::setw( 28 ) << "scope" << std::right << std::setw( 10 ) << "calls" << std::setw( 12 )
+    << "total (ms)" << std::setw( 12 ) << "mean (us)" << std::setw( 12 ) << "max (us)";
+  for ( const char* const name : counterNames )
+    out << std::setw( 16 ) << name;
+  out << '\n' << std::fixed << std::setprecision( 3 );
+  for ( const auto& [name, statistics] : byName )
+  {
+    out << std::left << std::setw( 28 ) << name << std::right << std::setw( 10 ) << statistics.calls
+      << std::setw( 12 ) << statistics.total / 1e6 << std::setw( 12 ) << statistics.total / 1e3 / statistics.calls
+      << std::setw( 12 ) << statistics.longest / 1e3;
+    for ( const std::uint64_t value : statistics.counters )
+      out << std::setw( 16 ) << value;
+    out << '\n';
+  }
+  out << std::defaultfloat;
+
+  for ( const auto& thread : threads )
+  {
+    out << "thread " << thread->index << " :";
+    for ( size_t i { 0 }; i < traceCounters; ++i )
+      out << ' ' << counterNames[i] << ' ' << thread->counters[i];
+    out << ", " << thread->written << " scopes, "
+      << (thread->written > traceCapacity ? thread->written - traceCapacity : 0) << " dropped\n";
+  }
+}
+
+// Timestamps of the Chrome format are in microseconds, so nanoseconds are written with 3 decimals.
+void trace_export_chrome( const std::string& fileName )
+{
+  std::ofstream file { fileName };
+  if ( !file )
+    throw std::runtime_error { "error: could not open the trace file for writing.\n" };
+
+  const std::lock_guard<std::mutex> lock { registryMutex };
+  file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n" << std::fixed << std::setprecision( 3 );
+  bool first { true };
+  for ( const auto& thread : threads )
+  {
+    file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->index
+      << ",\"args\":{\"name\":\"thread " << thread->index << "\"}}";
+    first = false;
+
+    // oldest first : once the ring has wrapped, it starts after the newest event
+    const size_t kept { thread->events.size() };
+    const size_t oldest { (thread->written > traceCapacity) ? static_cast<size_t>(thread->written % traceCapacity) : 0 };
+    for ( size_t i { 0 }; i < kept; ++i )
+    {
+      const TraceEvent& event { thread->events[(oldest + i) % kept] };
+      file << ",\n{\"name\":";
+      write_json_string( file, siteNames[event.site] );
+      file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->index << ",\"ts\":" << event.start / 1e3
+        << ",\"dur\":" << event.duration / 1e3 << ",\"args\":{";
+      for ( size_t counter { 0 }; counter < traceCounters; ++counter )
+        file << (counter ? "," : "") << '"' << counterNames[counter] << "\":" << event.counters[counter];
+      file << "}}";
+    }
+  }
+  file << "\n]}\n";
+  if ( !file )
+    throw std::runtime_error { "error: could not write the trace file.\n" };
+}
+
+void trace_reset()
+{
+  const std::lock_guard<std::mutex> lock { registryMutex };
+  for ( const auto& thread : threads )
+  {
+    thread->events.clear();
+    thread->written = 0;
+    std::fill( thread->counters, thread->counters + traceCounters, 0 );
+    thread->sites.clear();
+  }
+}
+
+#else
+
+void trace_summary( std::ostream& out )
+{
+  out << "tracing is compiled out, define TRACE_ENABLED to enable it\n";
+}
+
+// an empty trace, so that scripts reading the file still work
+void trace_export_chrome( const std::string& fileName )
+{
+  std::ofstream file { fileName };
+  if ( !(file << "{\"traceEvents\":[]}\n") )
+    throw std::runtime_error { "error: could not write the trace file.\n" };
+}
+
+void trace_reset() { }
+
+#endif
+
+
+/* Sorts random vectors with every working algorithm, multiplies and transposes matrices, and fills fibonacci
+ * ranges on several threads, then prints the summary and writes `trace.json` in the current working directory.
+ */
+void testTrace()
+{
+  trace_reset();
+
+  std::mt19937 generator { 2021 };
+  std::uniform_int_distribution<int> value { 0, 1 << 20 };
+  for ( const SortType type : { SortType::Insertion, SortType::Merge, SortType::Quick, SortType::Shell, SortType::STD } )
+  {
+    std::vector<int> data( (type == SortType::Insertion) ? 2000 : 100000 );
+    for ( auto& element : data )
+      element = value( generator );
+    sort { type }( data.begin(), data.end() );
+  }
+
+  Matrix<double> a { 256, 256 };
+  for ( auto& element : a )
+    element = value( generator ) / 1e6;
+  const Matrix<double> product { a * a.transpose() };
+  const Matrix<double> power { (a * 1e-3).pow( 5 ) };
+
+  std::vector<std::uint64_t> range( 1 << 20 );
+  fibonacci_range( 0, range.size(), range.data(), 1'000'000'007ULL, 4 );   // joins its workers before returning
+  fibonacci_big( 100000 );
+
+  trace_summary();
+  trace_export_chrome( "trace.json" );
+  std::cout << "wrote trace.json\n";
+}
\ No newline at end of file
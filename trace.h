@@ -0,0 +1,114 @@
+#ifndef __trace_h__
+#define __trace_h__
+
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uint32_t, std::uint64_t
+#include <iostream>         // std::ostream, std::cout
+#include <string>           // std::string
+
+using size_t = std::size_t;
+
+/*//////////////////////////////////////// Hot path tracing ////////////////////////////////////////
+ *
+ * Compiled in only when `TRACE_ENABLED` is defined (/D TRACE_ENABLED, -DTRACE_ENABLED). Otherwise the macros below
+ * expand to nothing, their arguments are not even evaluated, and the instrumented code is exactly the code
+ * without them. The summary and export functions still exist, and report that tracing is off.
+ * - `TRACE_SCOPE( name )` times the rest of the enclosing block. `name` must be a string literal (or any string
+ *   that outlives the program) : it is kept by pointer, in a function local static created once per call site.
+ * - `TRACE_ALLOCATION( bytes )` counts one heap allocation of `bytes`, `TRACE_MOVED( bytes )` counts bytes copied
+ *   or swapped. Counters are per thread, and every scope records how much they grew while it was open.
+ * Every thread writes only into its own buffers, so tracing takes no lock after the first event of a thread :
+ * a ring of the last `traceCapacity` scopes (older ones are overwritten, and counted as dropped), and the
+ * statistics of every call site, which see every scope. Both outlive the thread, so short-lived workers show up.
+ * A scope costs 2 reads of the steady clock and a few stores, about 50 ns, and a counter a function call : trace
+ * the calls of a loop, not its iterations.
+ * The summary, export and reset functions read the buffers of every thread without synchronizing with them :
+ * they must not run while other threads are tracing (run them after joining the workers, as in `testTrace`).
+ */
+
+constexpr size_t traceCapacity { 1 << 14 };               // scopes kept per thread, 48 bytes each
+
+// what the counters count
+enum class TraceCounter
+{
+  Allocations,                                            // heap allocations
+  AllocatedBytes,                                         // bytes requested by those allocations
+  MovedBytes                                              // bytes copied, moved or swapped
+};
+
+constexpr size_t traceCounters { 3 };                     // number of `TraceCounter` values
+
+#ifdef TRACE_ENABLED
+
+struct TraceThread;                                       // the buffers of one thread, in trace.cpp
+
+// one `TRACE_SCOPE` of the source, registered once with an index into the statistics of every thread
+class TraceSite
+{
+  const char* const __name;
+  const std::uint32_t __id;
+
+public:
+
+  explicit TraceSite( const char* name );
+  TraceSite( const TraceSite& ) = delete;                 // threads refer to the site by its index
+  TraceSite& operator=( const TraceSite& ) = delete;
+  const char* name() const { return __name; }
+  std::uint32_t id() const { return __id; }
+};
+
+// times its own lifetime, then records it in the ring and the statistics of the thread that created it
+class TraceScope
+{
+  const TraceSite& __site;
+  TraceThread& __buffers;
+  std::uint64_t __start;                                  // nanoseconds since the first use of tracing
+  std::uint64_t __counters[traceCounters];                // the counters of the thread when the scope opened
+
+public:
+
+  explicit TraceScope( const TraceSite& site );
+  TraceScope( const TraceScope& ) = delete;
+  TraceScope& operator=( const TraceScope& ) = delete;
+  ~TraceScope();
+};
+
+void trace_count( TraceCounter counter, std::uint64_t amount );   // adds to a counter of the calling thread
+
+#define TRACE_CONCATENATE_( a, b ) a##b
+#define TRACE_CONCATENATE( a, b ) TRACE_CONCATENATE_( a, b )
+#define TRACE_SCOPE( name )                                                               \
+  static const TraceSite TRACE_CONCATENATE( traceSite, __LINE__ ) { name };               \
+  const TraceScope TRACE_CONCATENATE( traceScope, __LINE__ ) { TRACE_CONCATENATE( traceSite, __LINE__ ) }
+#define TRACE_ALLOCATION( bytes ) \
+  ( trace_count( TraceCounter::Allocations, 1 ), trace_count( TraceCounter::AllocatedBytes, (bytes) ) )
+#define TRACE_MOVED( bytes ) trace_count( TraceCounter::MovedBytes, (bytes) )
+
+#else
+
+#define TRACE_SCOPE( name ) static_cast<void>(0)
+#define TRACE_ALLOCATION( bytes ) static_cast<void>(0)
+#define TRACE_MOVED( bytes ) static_cast<void>(0)
+
+#endif
+
+/* Prints one line per scope name (the instances of a template share theirs) : calls, total, mean and longest
+ * inclusive time, and the counters accumulated inside those scopes, then the counters and dropped scopes of
+ * every thread.
+ */
+void trace_summary( std::ostream& out = std::cout );
+
+/* Writes the scopes still in the rings as Chrome trace events ("X" events with the counters as arguments, one
+ * track per thread), viewable in chrome://tracing or https://ui.perfetto.dev. Throws `std::runtime_error` if the
+ * file can not be written.
+ */
+void trace_export_chrome( const std::string& fileName );
+
+// writes `text` quoted, with its quotes and backslashes escaped, for the trace and the benchmark baselines
+void write_json_string( std::ostream& out, const std::string& text );
+
+void trace_reset();                                       // empties the rings, statistics and counters of every thread
+
+void testTrace();                                         // traces sorts, matrix products and fibonacci ranges
+
+#endif
\ No newline at end of file